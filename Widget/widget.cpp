@@ -9,6 +9,8 @@
 helper class to test the functionality of containers
 throws error on value 43
 this is to test the exception handling
+copies and moves count the copy/move constructions and assignments of every Widget,
+so tests can check that a container does not copy where it could move
 */
 class Widget
 {
@@ -21,17 +23,27 @@ public:
             throw std::invalid_argument("Invalid value: 43");
     }
 
-    Widget(const Widget &other) : x_(other.x_) { WIDGET_TRACE(); }
-    Widget(Widget &&other) noexcept : x_(other.x_) { WIDGET_TRACE(); }
+    Widget(const Widget &other) : x_(other.x_)
+    {
+        ++copies;
+        WIDGET_TRACE();
+    }
+    Widget(Widget &&other) noexcept : x_(other.x_)
+    {
+        ++moves;
+        WIDGET_TRACE();
+    }
     Widget &operator=(const Widget &other)
     {
         x_ = other.x_;
+        ++copies;
         WIDGET_TRACE();
         return *this;
     }
     Widget &operator=(Widget &&other) noexcept
     {
         x_ = other.x_;
+        ++moves;
         WIDGET_TRACE();
         return *this;
     }
@@ -39,6 +51,15 @@ public:
 
     void doSomething() const { WIDGET_TRACE(); }
 
+    static void reset_counters()
+    {
+        copies = 0;
+        moves = 0;
+    }
+
+    static inline size_t copies = 0;
+    static inline size_t moves = 0;
+
     friend bool operator==(const Widget &lhs, const Widget &rhs)
     {
         return lhs.x_ == rhs.x_;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+
+/*
+helpers shared by the bench_*.cpp / bench.cpp programs
+every benchmark is a standalone program, e.g.
+  g++ -std=c++20 -O2 -march=native -pthread bench.cpp -o bench && ./bench
+*/
+
+/* keeps the optimizer from discarding a computed value */
+template <typename T> inline void do_not_optimize(const T &val) {
+  asm volatile("" : : "r,m"(val) : "memory");
+}
+
+/* returns wall-clock seconds spent running func() once */
+template <typename Func> double time_it(Func &&func) {
+  auto start = std::chrono::steady_clock::now();
+  func();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+/* returns the best of `repeat` runs of func(), which filters out scheduler noise */
+template <typename Func> double best_of(int repeat, Func &&func) {
+  double best = time_it(func);
+  for (int i = 1; i < repeat; ++i) {
+    double t = time_it(func);
+    if (t < best)
+      best = t;
+  }
+  return best;
+}
+
+/* deterministic generator so runs are comparable */
+inline std::mt19937_64 &bench_rng() {
+  static std::mt19937_64 rng(42);
+  return rng;
+}
@@ -0,0 +1,81 @@
+#include "./../benchmark.cpp"
+#include "./../forward_list/forward_list.cpp"
+#include "deque.cpp"
+
+#include <cstdlib>
+#include <deque>
+#include <new>
+
+/*
+work-list patterns against forward_list (one node per element) and std::deque
+  fifo       n push_back, then n pop_front
+  lifo       n push_front, then n pop_front
+  iterate    sum over n elements
+plus heap bytes per element while holding n elements
+usage: ./bench [elements]
+*/
+
+static size_t live_bytes = 0;
+
+void *operator new(size_t bytes) {
+  live_bytes += bytes;
+  if (void *p = std::malloc(bytes + 16)) {
+    *static_cast<size_t *>(p) = bytes;
+    return static_cast<char *>(p) + 16;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  if (!p)
+    return;
+  char *block = static_cast<char *>(p) - 16;
+  live_bytes -= *reinterpret_cast<size_t *>(block);
+  std::free(block);
+}
+
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+
+template <typename List> static void row(const char *name, size_t n) {
+  double fifo = best_of(3, [&] {
+    List list;
+    for (size_t i = 0; i != n; ++i)
+      list.push_back(i);
+    for (size_t i = 0; i != n; ++i)
+      list.pop_front();
+  });
+
+  double lifo = best_of(3, [&] {
+    List list;
+    for (size_t i = 0; i != n; ++i)
+      list.push_front(i);
+    for (size_t i = 0; i != n; ++i)
+      list.pop_front();
+  });
+
+  List list;
+  size_t before = live_bytes;
+  for (size_t i = 0; i != n; ++i)
+    list.push_back(i);
+  double bytes = double(live_bytes - before) / double(n);
+
+  double iterate = best_of(3, [&] {
+    uint64_t sum = 0;
+    for (uint64_t x : list)
+      sum += x;
+    do_not_optimize(sum);
+  });
+
+  std::printf("%-16s %10.2f %10.2f %10.2f %14.3f\n", name, fifo / n * 1e9, lifo / n * 1e9,
+              iterate / n * 1e9, bytes);
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+
+  std::printf("%zu uint64_t elements (ns per element)\n", n);
+  std::printf("%-16s %10s %10s %10s %14s\n", "", "fifo", "lifo", "iterate", "bytes/element");
+  row<deque<uint64_t>>("deque", n);
+  row<std::deque<uint64_t>>("std::deque", n);
+  row<forward_list<uint64_t>>("forward_list", n);
+}
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+double-ended queue over a map of fixed-size blocks
+
+elements live in raw blocks of block_size slots allocated like stack_base. the map is an
+array of block pointers with free slots at both ends, so push/pop at either end only ever
+construct or destroy one element and allocate or free at most one block: elements are
+never relocated and references stay valid until the element is popped.
+
+element k sits at the virtual position start_ + k, i.e. in block (start_ + k) / block_size.
+blocks are about 4 KiB, so the map and the two partially filled end blocks cost well below
+1% of the element storage once the deque holds more than a few blocks.
+*/
+template <typename T> class deque {
+public:
+  // a power of two so that indexing is a shift and a mask, at least 16 elements per block
+  static constexpr size_t block_size =
+      std::bit_floor(sizeof(T) * 16 > 4096 ? size_t(16) : 4096 / sizeof(T));
+
+private:
+  template <bool Const> class basic_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() : map_(nullptr), pos_(0) {}
+    basic_iterator(T *const *map, size_t pos) : map_(map), pos_(pos) {}
+
+    // iterator converts to const_iterator
+    template <bool OthConst, typename = std::enable_if_t<Const && !OthConst>>
+    basic_iterator(const basic_iterator<OthConst> &oth) : map_(oth.map_), pos_(oth.pos_) {}
+
+    reference operator*() const { return map_[pos_ / block_size][pos_ % block_size]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    basic_iterator &operator++() {
+      ++pos_;
+      return *this;
+    }
+    basic_iterator operator++(int) {
+      basic_iterator tmp(*this);
+      ++pos_;
+      return tmp;
+    }
+    basic_iterator &operator--() {
+      --pos_;
+      return *this;
+    }
+    basic_iterator operator--(int) {
+      basic_iterator tmp(*this);
+      --pos_;
+      return tmp;
+    }
+
+    basic_iterator &operator+=(difference_type n) {
+      pos_ += n;
+      return *this;
+    }
+    basic_iterator &operator-=(difference_type n) {
+      pos_ -= n;
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return difference_type(lhs.pos_) - difference_type(rhs.pos_);
+    }
+
+    friend bool operator==(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return lhs.pos_ == rhs.pos_;
+    }
+    friend bool operator!=(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return !(lhs == rhs);
+    }
+    friend bool operator<(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return lhs.pos_ < rhs.pos_;
+    }
+    friend bool operator>(const basic_iterator &lhs, const basic_iterator &rhs) { return rhs < lhs; }
+    friend bool operator<=(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return !(rhs < lhs);
+    }
+    friend bool operator>=(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return !(lhs < rhs);
+    }
+
+  private:
+    friend class deque;
+    template <bool> friend class basic_iterator;
+
+    T *const *map_;
+    size_t pos_; // virtual position, see deque
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  deque() : map_(nullptr), map_size_(0), start_(0), size_(0), spare_(nullptr) {}
+
+  // copy constructor
+  deque(const deque &oth) : deque() {
+    for (const T &val : oth)
+      push_back(val);
+  }
+
+  // copy assignment
+  deque &operator=(const deque &oth) {
+    // copy-and-swap idiom
+    deque tmp(oth);   // copy
+    swap(*this, tmp); // swap
+    return *this;
+  }
+
+  // move constructor
+  deque(deque &&oth) noexcept : deque() { swap(*this, oth); }
+
+  // move assignment
+  deque &operator=(deque &&oth) noexcept {
+    // move-and-swap idiom
+    deque tmp(std::move(oth)); // move
+    swap(*this, tmp);          // swap
+    return *this;
+  }
+
+  // destructor
+  ~deque() {
+    clear();
+    release_block(spare_);
+    ::operator delete(map_);
+  }
+
+  friend void swap(deque &lhs, deque &rhs) noexcept {
+    using std::swap;
+    swap(lhs.map_, rhs.map_);
+    swap(lhs.map_size_, rhs.map_size_);
+    swap(lhs.start_, rhs.start_);
+    swap(lhs.size_, rhs.size_);
+    swap(lhs.spare_, rhs.spare_);
+  }
+
+  void push_back(const T &val) {
+    if ((start_ + size_) / block_size == map_size_)
+      grow_map();
+
+    size_t pos = start_ + size_;
+    bool fresh = ensure_block(pos / block_size);
+    try {
+      new (slot(pos)) T(val);
+    } catch (...) {
+      if (fresh)
+        drop_block(pos / block_size);
+      throw;
+    }
+    ++size_;
+  }
+
+  void push_front(const T &val) {
+    if (start_ == 0)
+      grow_map();
+
+    size_t pos = start_ - 1;
+    bool fresh = ensure_block(pos / block_size);
+    try {
+      new (slot(pos)) T(val);
+    } catch (...) {
+      if (fresh)
+        drop_block(pos / block_size);
+      throw;
+    }
+    --start_;
+    ++size_;
+  }
+
+  void pop_back() {
+    if (empty())
+      throw "empty deque";
+
+    size_t pos = start_ + size_ - 1;
+    slot(pos)->~T();
+    --size_;
+    if (size_ == 0)
+      reset();
+    else if (pos % block_size == 0)
+      drop_block(pos / block_size);
+  }
+
+  void pop_front() {
+    if (empty())
+      throw "empty deque";
+
+    size_t pos = start_;
+    slot(pos)->~T();
+    ++start_;
+    --size_;
+    if (size_ == 0)
+      reset();
+    else if (start_ % block_size == 0)
+      drop_block(pos / block_size);
+  }
+
+  T &operator[](size_t index) noexcept { return *slot(start_ + index); }
+  const T &operator[](size_t index) const noexcept { return *slot(start_ + index); }
+
+  T &at(size_t index) {
+    if (index >= size_)
+      throw "index out of range";
+    return (*this)[index];
+  }
+
+  const T &at(size_t index) const {
+    if (index >= size_)
+      throw "index out of range";
+    return (*this)[index];
+  }
+
+  T &front() {
+    if (empty())
+      throw "empty deque";
+    return (*this)[0];
+  }
+
+  const T &front() const {
+    if (empty())
+      throw "empty deque";
+    return (*this)[0];
+  }
+
+  T &back() {
+    if (empty())
+      throw "empty deque";
+    return (*this)[size_ - 1];
+  }
+
+  const T &back() const {
+    if (empty())
+      throw "empty deque";
+    return (*this)[size_ - 1];
+  }
+
+  iterator begin() noexcept { return iterator(map_, start_); }
+  iterator end() noexcept { return iterator(map_, start_ + size_); }
+  const_iterator begin() const noexcept { return const_iterator(map_, start_); }
+  const_iterator end() const noexcept { return const_iterator(map_, start_ + size_); }
+
+  void clear() noexcept {
+    for (size_t pos = start_; pos != start_ + size_; ++pos)
+      slot(pos)->~T();
+    size_ = 0;
+    reset();
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return 0 == size_; }
+
+  /* bytes held by blocks and the map, for checking the per-element overhead */
+  size_t memory_bytes() const noexcept {
+    size_t blocks = spare_ ? 1 : 0;
+    for (size_t i = 0; i != map_size_; ++i)
+      blocks += map_[i] != nullptr;
+    return blocks * block_size * sizeof(T) + map_size_ * sizeof(T *);
+  }
+
+private:
+  T *slot(size_t pos) const noexcept { return map_[pos / block_size] + pos % block_size; }
+
+  /* allocates the block for map slot index unless present, returns whether it did */
+  bool ensure_block(size_t index) {
+    if (map_[index])
+      return false;
+    if (spare_) {
+      map_[index] = std::exchange(spare_, nullptr);
+    } else {
+      map_[index] = static_cast<T *>(::operator new(block_size * sizeof(T)));
+    }
+    return true;
+  }
+
+  /* one emptied block is kept so that push/pop alternating on a block edge does not allocate */
+  void drop_block(size_t index) noexcept {
+    T *block = std::exchange(map_[index], nullptr);
+    if (!spare_)
+      spare_ = block;
+    else
+      release_block(block);
+  }
+
+  static void release_block(T *block) noexcept {
+    if (block)
+      ::operator delete(block, block_size * sizeof(T));
+  }
+
+  /* frees every block of an empty deque and re-centres start_ */
+  void reset() noexcept {
+    for (size_t i = 0; i != map_size_; ++i)
+      if (map_[i])
+        drop_block(i);
+    start_ = map_size_ / 2 * block_size;
+  }
+
+  /*
+  makes room for one more block at both ends: blocks in use are re-centred in the
+  current map while it is at most half full, otherwise moved into a map twice the size
+  */
+  void grow_map() {
+    size_t first = start_ / block_size;
+    size_t used = size_ == 0 ? 0 : (start_ + size_ - 1) / block_size - first + 1;
+
+    size_t new_size = map_size_;
+    if (used * 2 >= map_size_ || map_size_ < 8)
+      new_size = map_size_ < 4 ? 8 : map_size_ * 2;
+
+    T **new_map = map_;
+    if (new_size != map_size_) {
+      new_map = static_cast<T **>(::operator new(new_size * sizeof(T *)));
+      std::fill(new_map, new_map + new_size, nullptr);
+    }
+
+    size_t new_first = (new_size - used) / 2;
+    if (new_map != map_) {
+      std::copy(map_ + first, map_ + first + used, new_map + new_first);
+      ::operator delete(map_);
+    } else if (new_first < first) {
+      std::copy(map_ + first, map_ + first + used, map_ + new_first);
+      std::fill(map_ + std::max(new_first + used, first), map_ + first + used, nullptr);
+    } else {
+      std::copy_backward(map_ + first, map_ + first + used, map_ + new_first + used);
+      std::fill(map_ + first, map_ + std::min(new_first, first + used), nullptr);
+    }
+
+    map_ = new_map;
+    map_size_ = new_size;
+    start_ = new_first * block_size + start_ % block_size;
+  }
+
+  T **map_;         // block pointers, null for slots without a block
+  size_t map_size_; // number of slots in map_
+  size_t start_;    // virtual position of the first element
+  size_t size_;
+  T *spare_;        // one cached empty block, or null
+};
@@ -0,0 +1,134 @@
+#define BOOST_TEST_MODULE DequeTests
+
+#include "deque.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(DequeTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization) {
+  deque<int> d;
+  BOOST_CHECK(d.empty());
+  BOOST_CHECK_EQUAL(d.size(), 0);
+  BOOST_CHECK(d.begin() == d.end());
+  BOOST_CHECK_THROW(d.front(), const char *);
+  BOOST_CHECK_THROW(d.back(), const char *);
+  BOOST_CHECK_THROW(d.pop_front(), const char *);
+  BOOST_CHECK_THROW(d.pop_back(), const char *);
+  BOOST_CHECK_THROW(d.at(0), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(PushBothEnds) {
+  deque<int> d;
+  const int n = 10000;
+  for (int i = 0; i != n; ++i) {
+    d.push_back(i);
+    d.push_front(-i - 1);
+  }
+
+  BOOST_REQUIRE_EQUAL(d.size(), 2 * n);
+  BOOST_CHECK_EQUAL(d.front(), -n);
+  BOOST_CHECK_EQUAL(d.back(), n - 1);
+  for (int i = 0; i != 2 * n; ++i)
+    BOOST_REQUIRE_EQUAL(d[i], i - n);
+}
+
+BOOST_AUTO_TEST_CASE(ReferencesStayValid) {
+  deque<std::string> d;
+  d.push_back("anchor");
+  const std::string *anchor = &d.front();
+
+  for (int i = 0; i != 5000; ++i) {
+    d.push_back("back");
+    d.push_front("front");
+  }
+  for (int i = 0; i != 4000; ++i)
+    d.pop_front();
+
+  BOOST_CHECK_EQUAL(*anchor, "anchor");
+  BOOST_CHECK_EQUAL(&d[1000], anchor);
+}
+
+BOOST_AUTO_TEST_CASE(QueueUsage_MatchesStdDeque) {
+  // a sliding window walks across the map, exercising re-centring and block reuse
+  deque<int> d;
+  std::deque<int> expected;
+  std::mt19937 rng(3);
+
+  for (int i = 0; i != 200000; ++i) {
+    int op = int(rng() % 8);
+    if (op < 3) {
+      d.push_back(i);
+      expected.push_back(i);
+    } else if (op < 4) {
+      d.push_front(i);
+      expected.push_front(i);
+    } else if (op < 6 && !expected.empty()) {
+      d.pop_front();
+      expected.pop_front();
+    } else if (!expected.empty()) {
+      d.pop_back();
+      expected.pop_back();
+    }
+    BOOST_REQUIRE_EQUAL(d.size(), expected.size());
+  }
+  BOOST_CHECK(std::equal(d.begin(), d.end(), expected.begin(), expected.end()));
+}
+
+BOOST_AUTO_TEST_CASE(RandomAccessIterators) {
+  deque<int> d;
+  for (int i = 0; i != 1000; ++i)
+    d.push_front(i);
+
+  std::sort(d.begin(), d.end());
+  BOOST_CHECK(std::is_sorted(d.begin(), d.end()));
+  BOOST_CHECK_EQUAL(d.end() - d.begin(), 1000);
+  BOOST_CHECK_EQUAL(d.begin()[500], 500);
+
+  auto it = std::lower_bound(d.begin(), d.end(), 700);
+  BOOST_CHECK_EQUAL(*it, 700);
+  BOOST_CHECK(it > d.begin());
+
+  const deque<int> &cd = d;
+  deque<int>::const_iterator cit = d.begin() + 3;
+  BOOST_CHECK(cit == cd.begin() + 3);
+  BOOST_CHECK_EQUAL(*cit, 3);
+}
+
+BOOST_AUTO_TEST_CASE(CopyMoveClear) {
+  deque<std::string> d;
+  for (int i = 0; i != 300; ++i)
+    d.push_back(std::to_string(i));
+
+  deque<std::string> copy(d);
+  d.pop_back();
+  BOOST_CHECK_EQUAL(copy.size(), 300);
+  BOOST_CHECK_EQUAL(copy.back(), "299");
+
+  deque<std::string> moved(std::move(copy));
+  BOOST_CHECK_EQUAL(moved.size(), 300);
+  BOOST_CHECK(copy.empty());
+
+  moved = d;
+  BOOST_CHECK_EQUAL(moved.size(), 299);
+  moved.clear();
+  BOOST_CHECK(moved.empty());
+  moved.push_front("again");
+  BOOST_CHECK_EQUAL(moved.at(0), "again");
+}
+
+BOOST_AUTO_TEST_CASE(MemoryOverhead) {
+  deque<uint64_t> d;
+  const size_t n = 1'000'000;
+  for (size_t i = 0; i != n; ++i)
+    d.push_back(i);
+
+  double overhead = double(d.memory_bytes()) / double(n * sizeof(uint64_t)) - 1.0;
+  BOOST_CHECK_LT(overhead, 0.01);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+#include "./../benchmark.cpp"
+#include "./../memory_accounting/memory_accounting.cpp"
+#include "./../stack/stack.cpp"
+#include "flat_combining.cpp"
+
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+contention: every thread pushes and pops the same container, flat_combining against the
+same container behind a std::mutex (the way threadsafe_queue guards it), over stack and
+over the std::queue of the serialized threadsafe_queue, for 1 to 64 threads
+usage: ./bench [operations per thread]
+*/
+
+using tagged_queue = std::queue<int, std::deque<int, tagged_allocator<int>>>;
+
+/* the plain-locking baseline, with the same apply() interface */
+template <typename Container> class locked {
+public:
+  template <typename Op> auto apply(Op &&op) {
+    std::lock_guard<std::mutex> lk(m_);
+    return op(data_);
+  }
+
+private:
+  Container data_;
+  std::mutex m_;
+};
+
+struct stack_ops {
+  using container = stack<int>;
+  static void push(container &s, int val) { s.push(val); }
+  static std::optional<int> pop(container &s) {
+    if (s.empty())
+      return std::nullopt;
+    return s.pop_value();
+  }
+};
+
+struct queue_ops {
+  using container = tagged_queue;
+  static void push(container &q, int val) { q.push(val); }
+  static std::optional<int> pop(container &q) {
+    if (q.empty())
+      return std::nullopt;
+    int val = q.front();
+    q.pop();
+    return val;
+  }
+};
+
+template <typename Ops, typename Wrapper> static double run(int threads, size_t ops) {
+  return best_of(3, [&] {
+    Wrapper w;
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+      workers.emplace_back([&w, ops] {
+        long long sum = 0;
+        for (size_t i = 0; i != ops; ++i) {
+          w.apply([i](typename Ops::container &c) { Ops::push(c, int(i)); });
+          if (std::optional<int> val =
+                  w.apply([](typename Ops::container &c) { return Ops::pop(c); }))
+            sum += *val;
+        }
+        do_not_optimize(sum);
+      });
+    for (std::thread &worker : workers)
+      worker.join();
+  });
+}
+
+template <typename Ops> static void table(const char *name, size_t ops) {
+  std::printf("%s\n%-8s %14s %14s\n", name, "threads", "combining", "mutex");
+  for (int threads = 1; threads <= 64; threads *= 2) {
+    double combining = run<Ops, flat_combining<typename Ops::container>>(threads, ops);
+    double mutex = run<Ops, locked<typename Ops::container>>(threads, ops);
+    double pairs = double(ops) * threads;
+    std::printf("%-8d %14.2f %14.2f\n", threads, combining / pairs * 1e9, mutex / pairs * 1e9);
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+
+  std::printf("%zu push+pop pairs per thread, %u hardware threads (ns per pair)\n", ops,
+              std::thread::hardware_concurrency());
+  table<stack_ops>("stack", ops);
+  table<queue_ops>("serialized queue container", ops);
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+/*
+flat-combining wrapper around a sequential container
+
+instead of every thread taking a lock and touching the container itself, a thread writes
+its operation into its own publication record and then either waits for the result or,
+if the lock is free, becomes the combiner: it applies every pending operation it finds in
+the records, its own included, to the container in one pass and hands out the results.
+under contention the container, the lock and the records stay in the combiner's cache
+and a waiting thread only touches its own record, so the lock's cache line is not
+bounced between cores on every operation the way it is with a plain mutex.
+
+operations are callables taking Container& and run on whichever thread combines, e.g.
+  flat_combining<stack<int>> st;
+  st.apply([](stack<int> &s) { s.push(1); });
+  int top = st.apply([](stack<int> &s) { return s.pop_value(); });
+results are returned by value, an exception thrown by an operation is rethrown to the
+thread that posted it. an operation must not call apply() on the same wrapper.
+
+each thread gets one record per wrapper on its first apply(); records are kept until the
+wrapper is destroyed, a thread that exits leaves its record for the next one to reuse.
+*/
+template <typename Container>
+class flat_combining
+{
+public:
+    template <typename... Args>
+    explicit flat_combining(Args &&...args)
+        : data_(std::forward<Args>(args)...), id_(next_id_.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    flat_combining(const flat_combining &) = delete;
+    flat_combining &operator=(const flat_combining &) = delete;
+
+    ~flat_combining()
+    {
+        for (record *rec = records_.load(std::memory_order_relaxed); rec != nullptr;)
+            delete std::exchange(rec, rec->next_);
+    }
+
+    /* runs op(container) under mutual exclusion with every other operation, returns its result */
+    template <typename Op>
+    std::remove_cvref_t<std::invoke_result_t<Op &, Container &>> apply(Op &&op)
+    {
+        using result_type = std::remove_cvref_t<std::invoke_result_t<Op &, Container &>>;
+        if constexpr (std::is_void_v<result_type>)
+        {
+            execute([&op](Container &data)
+                    { op(data); });
+        }
+        else
+        {
+            std::optional<result_type> result;
+            execute([&op, &result](Container &data)
+                    { result.emplace(op(data)); });
+            return std::move(*result);
+        }
+    }
+
+    /* direct access, only while no other thread can call apply() */
+    Container &unsafe_container() noexcept { return data_; }
+
+    /* combining passes run so far, a rough measure of how much batching happened */
+    uint64_t passes() const noexcept { return passes_.load(std::memory_order_relaxed); }
+
+private:
+    // how often the combiner rescans the records for operations posted while it was running
+    static constexpr int scans_per_pass = 3;
+
+    struct alignas(64) record
+    {
+        explicit record(std::thread::id owner) : owner_(owner) {}
+
+        std::atomic<bool> pending_{false}; // set by the owner, cleared by the combiner
+        void (*run_)(void *, Container &) = nullptr;
+        void *op_ = nullptr;
+        std::exception_ptr error_;
+        const std::thread::id owner_;
+        record *next_ = nullptr;
+    };
+
+    template <typename F>
+    void execute(F &&f)
+    {
+        record &rec = own_record();
+        rec.op_ = &f;
+        rec.run_ = [](void *op, Container &data)
+        { (*static_cast<std::remove_reference_t<F> *>(op))(data); };
+        // release publishes op_ and run_ to the combiner
+        rec.pending_.store(true, std::memory_order_release);
+
+        // acquire pairs with the combiner's release, which published the result
+        while (rec.pending_.load(std::memory_order_acquire))
+        {
+            if (!locked_.load(std::memory_order_relaxed) &&
+                !locked_.exchange(true, std::memory_order_acquire))
+            {
+                combine();
+                locked_.store(false, std::memory_order_release);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (rec.error_)
+            std::rethrow_exception(std::exchange(rec.error_, nullptr));
+    }
+
+    // called with the lock held
+    void combine()
+    {
+        passes_.fetch_add(1, std::memory_order_relaxed);
+        for (int scan = 0; scan != scans_per_pass; ++scan)
+        {
+            bool ran = false;
+            for (record *rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next_)
+            {
+                if (!rec->pending_.load(std::memory_order_acquire))
+                    continue;
+                try
+                {
+                    rec->run_(rec->op_, data_);
+                }
+                catch (...)
+                {
+                    rec->error_ = std::current_exception();
+                }
+                rec->pending_.store(false, std::memory_order_release);
+                ran = true;
+            }
+            if (!ran)
+                return;
+        }
+    }
+
+    /* the calling thread's record, created and linked in on its first call */
+    record &own_record()
+    {
+        if (cached_.id_ == id_)
+            return *cached_.record_;
+
+        std::thread::id self = std::this_thread::get_id();
+        record *rec = records_.load(std::memory_order_acquire);
+        while (rec != nullptr && rec->owner_ != self)
+            rec = rec->next_;
+
+        if (rec == nullptr)
+        {
+            rec = new record(self);
+            rec->next_ = records_.load(std::memory_order_relaxed);
+            // release publishes the record to combiners walking the list
+            while (!records_.compare_exchange_weak(rec->next_, rec, std::memory_order_release,
+                                                   std::memory_order_relaxed))
+                ;
+        }
+
+        cached_ = {id_, rec};
+        return *rec;
+    }
+
+    // last wrapper this thread used and its record there, ids are never reused
+    struct record_cache
+    {
+        uint64_t id_ = 0;
+        record *record_ = nullptr;
+    };
+    static inline thread_local record_cache cached_;
+    static inline std::atomic<uint64_t> next_id_{1};
+
+    Container data_;
+    const uint64_t id_;
+    alignas(64) std::atomic<bool> locked_{false};
+    std::atomic<uint64_t> passes_{0};
+    std::atomic<record *> records_{nullptr};
+};
@@ -0,0 +1,164 @@
+#define BOOST_TEST_MODULE FlatCombiningTests
+
+#include "flat_combining.cpp"
+#include "./../stack/stack.cpp"
+#include "./../memory_accounting/memory_accounting.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// the container behind the serialized threadsafe_queue
+using tagged_queue = std::queue<int, std::deque<int, tagged_allocator<int>>>;
+
+BOOST_AUTO_TEST_SUITE(FlatCombiningTestSuite)
+
+BOOST_AUTO_TEST_CASE(AppliesOperationsToStack)
+{
+    flat_combining<stack<int>> st;
+    st.apply([](stack<int> &s)
+             { s.push(1); });
+    st.apply([](stack<int> &s)
+             { s.push(2); });
+
+    BOOST_CHECK_EQUAL(st.apply([](stack<int> &s)
+                               { return s.size(); }),
+                      2u);
+    BOOST_CHECK_EQUAL(st.apply([](stack<int> &s)
+                               { return s.pop_value(); }),
+                      2);
+    // a reference result is copied out before the lock is let go
+    int &top = st.unsafe_container().top();
+    int copy = st.apply([](stack<int> &s) -> int &
+                        { return s.top(); });
+    BOOST_CHECK_EQUAL(copy, 1);
+    BOOST_CHECK(&copy != &top);
+}
+
+BOOST_AUTO_TEST_CASE(ForwardsConstructorArguments)
+{
+    std::deque<int, tagged_allocator<int>> items(tagged_allocator<int>(memory_tag("queue")));
+    items.push_back(4);
+    items.push_back(5);
+    flat_combining<tagged_queue> q(std::move(items));
+
+    q.apply([](tagged_queue &data)
+            { data.pop(); });
+    BOOST_CHECK_EQUAL(q.apply([](tagged_queue &data)
+                              { return data.front(); }),
+                      5);
+}
+
+BOOST_AUTO_TEST_CASE(RethrowsToPoster)
+{
+    flat_combining<stack<int>> st;
+    BOOST_CHECK_THROW(st.apply([](stack<int> &s)
+                               { return s.pop_value(); }),
+                      const char *);
+    // the wrapper is still usable after an operation threw
+    st.apply([](stack<int> &s)
+             { s.push(3); });
+    BOOST_CHECK_EQUAL(st.apply([](stack<int> &s)
+                               { return s.top(); }),
+                      3);
+}
+
+BOOST_AUTO_TEST_CASE(OneThreadAlternatesWrappers)
+{
+    flat_combining<stack<std::string>> a, b;
+    for (int i = 0; i != 10; ++i)
+    {
+        a.apply([i](stack<std::string> &s)
+                { s.push("a" + std::to_string(i)); });
+        b.apply([i](stack<std::string> &s)
+                { s.push("b" + std::to_string(i)); });
+    }
+    BOOST_CHECK_EQUAL(a.apply([](stack<std::string> &s)
+                              { return s.top(); }),
+                      "a9");
+    BOOST_CHECK_EQUAL(b.apply([](stack<std::string> &s)
+                              { return s.size(); }),
+                      10u);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentQueueKeepsEveryElement)
+{
+    constexpr int threads = 8, per_thread = 5000;
+    flat_combining<tagged_queue> q;
+    std::atomic<long long> popped_sum{0};
+    std::atomic<int> popped{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+        workers.emplace_back([&, t]
+                             {
+            long long sum = 0;
+            int count = 0;
+            for (int i = 0; i != per_thread; ++i)
+            {
+                int val = t * per_thread + i;
+                q.apply([val](tagged_queue &data) { data.push(val); });
+                std::optional<int> out = q.apply([](tagged_queue &data) -> std::optional<int> {
+                    if (data.empty())
+                        return std::nullopt;
+                    int front = data.front();
+                    data.pop();
+                    return front;
+                });
+                if (out)
+                {
+                    sum += *out;
+                    ++count;
+                }
+            }
+            popped_sum += sum;
+            popped += count; });
+    for (std::thread &w : workers)
+        w.join();
+
+    // whatever was not popped is still in the queue
+    long long left_sum = 0;
+    tagged_queue &rest = q.unsafe_container();
+    int left = int(rest.size());
+    for (; !rest.empty(); rest.pop())
+        left_sum += rest.front();
+
+    long long n = threads * per_thread;
+    BOOST_CHECK_EQUAL(popped + left, n);
+    BOOST_CHECK_EQUAL(popped_sum + left_sum, n * (n - 1) / 2);
+    BOOST_CHECK(q.passes() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(OperationsRunAtomically)
+{
+    constexpr int threads = 4, per_thread = 2000;
+    flat_combining<stack<int>> st;
+    std::atomic<bool> ordered{true};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+        workers.emplace_back([&]
+                             {
+            for (int i = 0; i != per_thread; ++i)
+            {
+                // a push and the pop of the same element in one operation see no interleaving
+                bool ok = st.apply([i](stack<int> &s) {
+                    s.push(i);
+                    return s.pop_value() == i;
+                });
+                if (!ok)
+                    ordered = false;
+            } });
+    for (std::thread &w : workers)
+        w.join();
+
+    BOOST_CHECK(ordered);
+    BOOST_CHECK(st.unsafe_container().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
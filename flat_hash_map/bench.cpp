@@ -0,0 +1,54 @@
+#include "./../benchmark.cpp"
+#include "flat_hash_map.cpp"
+
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+/*
+inserts, successful lookups and failed lookups against std::unordered_map
+usage: ./bench [keys]
+*/
+template <typename Map> void run(const char *name, const std::vector<uint64_t> &keys,
+                                 const std::vector<uint64_t> &misses) {
+  Map map;
+  double insert = best_of(1, [&] {
+    for (uint64_t k : keys)
+      map[k] = k;
+  });
+
+  double hits = best_of(3, [&] {
+    uint64_t sum = 0;
+    for (uint64_t k : keys)
+      sum += map.find(k)->second;
+    do_not_optimize(sum);
+  });
+
+  double miss = best_of(3, [&] {
+    size_t found = 0;
+    for (uint64_t k : misses)
+      found += map.find(k) != map.end();
+    do_not_optimize(found);
+  });
+
+  double n = double(keys.size());
+  std::printf("%-20s %12.1f %12.1f %12.1f\n", name, insert / n * 1e9, hits / n * 1e9,
+              miss / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+
+  // even keys are inserted, odd keys are guaranteed misses
+  std::vector<uint64_t> keys(count), misses(count);
+  for (size_t i = 0; i != count; ++i) {
+    uint64_t r = bench_rng()() & ~uint64_t(1);
+    keys[i] = r;
+    misses[i] = r | 1;
+  }
+
+  std::printf("%-20s %12s %12s %12s   (ns per op, %zu keys)\n", "map", "insert", "hit", "miss",
+              count);
+  run<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map", keys, misses);
+  run<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, misses);
+}
@@ -0,0 +1,489 @@
+#include "./../vector/vector_base.cpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+open-addressing hash map in the style of swiss tables
+
+one vector_base allocation holds a control byte per slot followed by the slots themselves.
+a control byte is either empty, deleted (tombstone) or the low 7 bits of the element's hash.
+lookups probe groups of 16 control bytes with one SSE2 compare and only touch the slots
+whose control byte matches, groups are visited in triangular order.
+
+keys must not be modified through iterators.
+*/
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+public:
+  using value_type = std::pair<Key, Value>;
+
+private:
+  static constexpr size_t group_width = 16;
+  static constexpr size_t npos = size_t(-1);
+  static constexpr int8_t ctrl_empty = -128;
+  static constexpr int8_t ctrl_deleted = -2;
+
+  static_assert(alignof(value_type) <= group_width, "slots are placed right after the control bytes");
+
+  /* the control bytes of one group, every match is a bit mask over its 16 slots */
+  class group {
+  public:
+#ifdef __SSE2__
+    explicit group(const int8_t *ctrl)
+        : ctrl_(_mm_load_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+    uint32_t match(int8_t h2) const {
+      return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+    }
+
+    uint32_t match_empty() const { return match(ctrl_empty); }
+
+    // empty and deleted are the only negative control bytes
+    uint32_t match_empty_or_deleted() const { return uint32_t(_mm_movemask_epi8(ctrl_)); }
+
+  private:
+    __m128i ctrl_;
+#else
+    explicit group(const int8_t *ctrl) : ctrl_(ctrl) {}
+
+    uint32_t match(int8_t h2) const {
+      uint32_t mask = 0;
+      for (size_t i = 0; i != group_width; ++i)
+        mask |= uint32_t(ctrl_[i] == h2) << i;
+      return mask;
+    }
+
+    uint32_t match_empty() const { return match(ctrl_empty); }
+
+    uint32_t match_empty_or_deleted() const {
+      uint32_t mask = 0;
+      for (size_t i = 0; i != group_width; ++i)
+        mask |= uint32_t(ctrl_[i] < 0) << i;
+      return mask;
+    }
+
+  private:
+    const int8_t *ctrl_;
+#endif
+  };
+
+  template <bool Const> class basic_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<Key, Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+    basic_iterator() : ctrl_(nullptr), slots_(nullptr), index_(0), capacity_(0) {}
+
+    // iterator converts to const_iterator
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    basic_iterator(const basic_iterator<false> &oth)
+        : ctrl_(oth.ctrl_), slots_(oth.slots_), index_(oth.index_), capacity_(oth.capacity_) {}
+
+    reference operator*() const { return slots_[index_]; }
+    pointer operator->() const { return slots_ + index_; }
+
+    basic_iterator &operator++() {
+      ++index_;
+      skip_free();
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return lhs.index_ == rhs.index_;
+    }
+
+    friend bool operator!=(const basic_iterator &lhs, const basic_iterator &rhs) {
+      return !(operator==(lhs, rhs));
+    }
+
+    friend class flat_hash_map;
+    template <bool> friend class basic_iterator;
+
+  private:
+    basic_iterator(const int8_t *ctrl, pointer slots, size_t index, size_t capacity)
+        : ctrl_(ctrl), slots_(slots), index_(index), capacity_(capacity) {
+      skip_free();
+    }
+
+    void skip_free() {
+      while (index_ < capacity_ && ctrl_[index_] < 0)
+        ++index_;
+    }
+
+    const int8_t *ctrl_;
+    pointer slots_;
+    size_t index_;
+    size_t capacity_;
+  };
+
+public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  flat_hash_map(const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+      : hash_(hash), eq_(eq), ctrl_(nullptr), slots_(nullptr), capacity_(0), size_(0),
+        growth_left_(0) {}
+
+  // copy constructor
+  flat_hash_map(const flat_hash_map &oth) : flat_hash_map(oth.hash_, oth.eq_) {
+    if (oth.capacity_ == 0)
+      return;
+
+    allocate(oth.capacity_);
+    size_t i = 0;
+    try {
+      for (; i != capacity_; ++i)
+        if (oth.ctrl_[i] >= 0)
+          new (slots_ + i) value_type(oth.slots_[i]);
+    } catch (...) {
+      for (size_t j = 0; j != i; ++j)
+        if (oth.ctrl_[j] >= 0)
+          slots_[j].~value_type();
+      throw;
+    }
+
+    std::memcpy(ctrl_, oth.ctrl_, capacity_);
+    size_ = oth.size_;
+    growth_left_ = oth.growth_left_;
+  }
+
+  // copy assignment
+  flat_hash_map &operator=(const flat_hash_map &oth) {
+    // copy-and-swap idiom
+    flat_hash_map tmp(oth); // copy
+    swap(*this, tmp);       // swap
+    return *this;
+  }
+
+  // move constructor
+  flat_hash_map(flat_hash_map &&oth) noexcept
+      : hash_(std::move(oth.hash_)), eq_(std::move(oth.eq_)), storage_(std::move(oth.storage_)),
+        ctrl_(oth.ctrl_), slots_(oth.slots_), capacity_(oth.capacity_), size_(oth.size_),
+        growth_left_(oth.growth_left_) {
+    oth.ctrl_ = nullptr;
+    oth.slots_ = nullptr;
+    oth.capacity_ = oth.size_ = oth.growth_left_ = 0;
+  }
+
+  // move assignment
+  flat_hash_map &operator=(flat_hash_map &&oth) noexcept {
+    // move and swap idiom
+    flat_hash_map tmp(std::move(oth)); // move
+    swap(*this, tmp);                  // swap
+    return *this;
+  }
+
+  ~flat_hash_map() { destroy_all(); }
+
+  friend void swap(flat_hash_map &lhs, flat_hash_map &rhs) noexcept {
+    using std::swap;
+    swap(lhs.hash_, rhs.hash_);
+    swap(lhs.eq_, rhs.eq_);
+    swap(lhs.storage_, rhs.storage_);
+    swap(lhs.ctrl_, rhs.ctrl_);
+    swap(lhs.slots_, rhs.slots_);
+    swap(lhs.capacity_, rhs.capacity_);
+    swap(lhs.size_, rhs.size_);
+    swap(lhs.growth_left_, rhs.growth_left_);
+  }
+
+  iterator begin() { return iterator(ctrl_, slots_, 0, capacity_); }
+  iterator end() { return iterator(ctrl_, slots_, capacity_, capacity_); }
+  const_iterator begin() const { return const_iterator(ctrl_, slots_, 0, capacity_); }
+  const_iterator end() const { return const_iterator(ctrl_, slots_, capacity_, capacity_); }
+
+  std::pair<iterator, bool> insert(const value_type &val) { return emplace_key(val.first, val.second); }
+
+  std::pair<iterator, bool> insert(value_type &&val) {
+    return emplace_key(std::move(val.first), std::move(val.second));
+  }
+
+  /* bulk insert, sizes the table once for forward ranges */
+  template <typename Iter> void insert(Iter first, Iter last) {
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                    typename std::iterator_traits<Iter>::iterator_category>)
+      reserve(size_ + std::distance(first, last));
+
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  /* constructs the value from args only if key is not present */
+  template <typename... Args> std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return emplace_key(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args> std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+    return emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+
+  Value &operator[](const Key &key) { return try_emplace(key).first->second; }
+  Value &operator[](Key &&key) { return try_emplace(std::move(key)).first->second; }
+
+  Value &at(const Key &key) {
+    size_t index = find_index(key);
+    if (index == npos)
+      throw "key not found";
+    return slots_[index].second;
+  }
+
+  const Value &at(const Key &key) const {
+    size_t index = find_index(key);
+    if (index == npos)
+      throw "key not found";
+    return slots_[index].second;
+  }
+
+  iterator find(const Key &key) { return iterator_at(find_index(key)); }
+  const_iterator find(const Key &key) const { return const_iterator_at(find_index(key)); }
+  bool contains(const Key &key) const { return find_index(key) != npos; }
+  size_t count(const Key &key) const { return contains(key) ? 1 : 0; }
+  size_t erase(const Key &key) { return erase_index(find_index(key)); }
+
+  // heterogeneous lookup, enabled when both Hash and KeyEqual declare is_transparent
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent, typename = typename E::is_transparent>
+  iterator find(const K &key) {
+    return iterator_at(find_index(key));
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent, typename = typename E::is_transparent>
+  const_iterator find(const K &key) const {
+    return const_iterator_at(find_index(key));
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent, typename = typename E::is_transparent>
+  bool contains(const K &key) const {
+    return find_index(key) != npos;
+  }
+
+  template <typename K, typename H = Hash, typename E = KeyEqual,
+            typename = typename H::is_transparent, typename = typename E::is_transparent>
+  size_t erase(const K &key) {
+    return erase_index(find_index(key));
+  }
+
+  iterator erase(iterator pos) {
+    erase_index(pos.index_);
+    return ++pos;
+  }
+
+  void clear() {
+    destroy_all();
+    size_ = 0;
+    growth_left_ = max_load(capacity_);
+  }
+
+  /* makes room for count elements without further rehashing */
+  void reserve(size_t count) {
+    size_t new_capacity = group_width;
+    while (max_load(new_capacity) < count)
+      new_capacity *= 2;
+
+    if (new_capacity > capacity_)
+      rehash(new_capacity);
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return 0 == size_; }
+  size_t capacity() const noexcept { return capacity_; }
+  double load_factor() const noexcept { return capacity_ ? double(size_) / capacity_ : 0.0; }
+
+private:
+  /* at most 7/8 of the slots are used before the table grows */
+  static size_t max_load(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+  /* spreads weak hashes such as the identity std::hash<int> over all bits */
+  template <typename K> size_t hash_of(const K &key) const {
+    uint64_t h = uint64_t(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return size_t(h ^ (h >> 32));
+  }
+
+  static int8_t h2(size_t hash) noexcept { return int8_t(hash & 0x7f); }
+
+  iterator iterator_at(size_t index) {
+    return iterator(ctrl_, slots_, index == npos ? capacity_ : index, capacity_);
+  }
+
+  const_iterator const_iterator_at(size_t index) const {
+    return const_iterator(ctrl_, slots_, index == npos ? capacity_ : index, capacity_);
+  }
+
+  template <typename K> size_t find_index(const K &key) const {
+    return capacity_ ? find_index(key, hash_of(key)) : npos;
+  }
+
+  template <typename K> size_t find_index(const K &key, size_t hash) const {
+    size_t mask = capacity_ / group_width - 1;
+    size_t g = (hash >> 7) & mask;
+
+    for (size_t step = 1;; ++step) {
+      group grp(ctrl_ + g * group_width);
+      for (uint32_t match = grp.match(h2(hash)); match; match &= match - 1) {
+        size_t index = g * group_width + std::countr_zero(match);
+        if (eq_(slots_[index].first, key))
+          return index;
+      }
+
+      // the table always keeps empty slots, so every probe sequence ends
+      if (grp.match_empty())
+        return npos;
+      g = (g + step) & mask;
+    }
+  }
+
+  /* first empty or deleted slot on the probe sequence of hash */
+  size_t find_insert_slot(size_t hash) const {
+    size_t mask = capacity_ / group_width - 1;
+    size_t g = (hash >> 7) & mask;
+
+    for (size_t step = 1;; ++step) {
+      uint32_t match = group(ctrl_ + g * group_width).match_empty_or_deleted();
+      if (match)
+        return g * group_width + std::countr_zero(match);
+      g = (g + step) & mask;
+    }
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace_key(K &&key, Args &&...args) {
+    size_t hash = hash_of(key);
+    size_t index = capacity_ ? find_index(key, hash) : npos;
+    if (index != npos)
+      return {iterator_at(index), false};
+
+    index = capacity_ ? find_insert_slot(hash) : npos;
+    if (index == npos || (growth_left_ == 0 && ctrl_[index] == ctrl_empty)) {
+      grow();
+      index = find_insert_slot(hash);
+    }
+
+    new (slots_ + index) value_type(std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<K>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+    if (ctrl_[index] == ctrl_empty)
+      --growth_left_;
+    ctrl_[index] = h2(hash);
+    ++size_;
+
+    return {iterator_at(index), true};
+  }
+
+  size_t erase_index(size_t index) {
+    if (index == npos)
+      return 0;
+
+    slots_[index].~value_type();
+    --size_;
+
+    // a group that still has an empty slot never made a probe sequence continue past it
+    if (group(ctrl_ + index / group_width * group_width).match_empty()) {
+      ctrl_[index] = ctrl_empty;
+      ++growth_left_;
+    } else {
+      ctrl_[index] = ctrl_deleted;
+    }
+    return 1;
+  }
+
+  /* doubles the table, or only drops tombstones when fewer than half the slots are live */
+  void grow() {
+    if (capacity_ == 0)
+      rehash(group_width);
+    else if (size_ < max_load(capacity_) / 2)
+      rehash(capacity_);
+    else
+      rehash(capacity_ * 2);
+  }
+
+  /* allocates control bytes and slots of an empty table, capacity is a power of two */
+  void allocate(size_t capacity) {
+    size_t bytes = capacity + capacity * sizeof(value_type);
+    vector_base<unsigned char> storage(bytes);
+    storage.end_ = storage.capacity_;
+
+    swap(storage_, storage);
+    ctrl_ = reinterpret_cast<int8_t *>(storage_.start_);
+    slots_ = reinterpret_cast<value_type *>(storage_.start_ + capacity);
+    capacity_ = capacity;
+    growth_left_ = max_load(capacity);
+    std::memset(ctrl_, ctrl_empty, capacity);
+  }
+
+  /*
+  moves every element into a table of new_capacity slots, like vector::reserve the old
+  elements are destroyed only after all of them were moved
+  */
+  void rehash(size_t new_capacity) {
+    flat_hash_map tmp(hash_, eq_);
+    tmp.allocate(new_capacity);
+
+    for (size_t i = 0; i != capacity_; ++i) {
+      if (ctrl_[i] < 0)
+        continue;
+
+      size_t hash = hash_of(slots_[i].first);
+      size_t index = tmp.find_insert_slot(hash);
+      if constexpr (is_trivially_relocatable)
+        std::memcpy(static_cast<void *>(tmp.slots_ + index), slots_ + i, sizeof(value_type));
+      else
+        new (tmp.slots_ + index) value_type(std::move(slots_[i]));
+      tmp.ctrl_[index] = h2(hash);
+      ++tmp.size_;
+      --tmp.growth_left_;
+    }
+
+    if constexpr (is_trivially_relocatable) {
+      if (capacity_ != 0) // an empty map has no control bytes yet, ctrl_ is null
+        std::memset(ctrl_, ctrl_empty, capacity_);
+    } else {
+      destroy_all();
+    }
+    swap(*this, tmp);
+  }
+
+  /* destroys every element and marks all slots empty */
+  void destroy_all() {
+    for (size_t i = 0; i != capacity_; ++i) {
+      if (ctrl_[i] >= 0)
+        slots_[i].~value_type();
+      ctrl_[i] = ctrl_empty;
+    }
+  }
+
+  static constexpr bool is_trivially_relocatable =
+      std::is_trivially_copy_constructible_v<value_type> &&
+      std::is_trivially_destructible_v<value_type>;
+
+  Hash hash_;
+  KeyEqual eq_;
+  vector_base<unsigned char> storage_; // capacity_ control bytes followed by capacity_ slots
+  int8_t *ctrl_;                       // control byte of every slot
+  value_type *slots_;                  // elements, constructed where ctrl_ is a hash byte
+  size_t capacity_;                    // number of slots, a power of two and a multiple of 16
+  size_t size_;
+  size_t growth_left_; // inserts into empty slots left before the table must grow
+};
@@ -0,0 +1,212 @@
+#define BOOST_TEST_MODULE FlatHashMapTests
+
+#include "./../Widget/widget.cpp"
+#include "flat_hash_map.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// hasher and comparator that let a string keyed map be probed with string_view
+struct string_hash {
+  using is_transparent = void;
+  size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+};
+
+struct string_equal {
+  using is_transparent = void;
+  bool operator()(std::string_view lhs, std::string_view rhs) const { return lhs == rhs; }
+};
+
+BOOST_AUTO_TEST_SUITE(FlatHashMapTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization) {
+  flat_hash_map<int, int> map;
+  BOOST_CHECK(map.empty());
+  BOOST_CHECK_EQUAL(map.size(), 0);
+  BOOST_CHECK_EQUAL(map.capacity(), 0);
+  BOOST_CHECK(map.find(1) == map.end());
+  BOOST_CHECK(!map.contains(1));
+  BOOST_CHECK(map.begin() == map.end());
+  BOOST_CHECK_THROW(map.at(1), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(InsertAndFind) {
+  flat_hash_map<int, int> map;
+  BOOST_CHECK(map.insert({1, 10}).second);
+  BOOST_CHECK(map.insert({2, 20}).second);
+  BOOST_CHECK(!map.insert({1, 99}).second); // existing key is kept
+
+  BOOST_CHECK_EQUAL(map.size(), 2);
+  BOOST_CHECK_EQUAL(map.find(1)->second, 10);
+  BOOST_CHECK_EQUAL(map.at(2), 20);
+  BOOST_CHECK(map.find(3) == map.end());
+}
+
+// growing a table without storage must not touch its null control bytes, which
+// -fsanitize=undefined reports
+BOOST_AUTO_TEST_CASE(FirstInsertGrowsEmptyTable) {
+  flat_hash_map<int, int> map;
+  map[1] = 10;
+  BOOST_CHECK_EQUAL(map.at(1), 10);
+  BOOST_CHECK(map.capacity() > 0);
+
+  flat_hash_map<int, int> moved(std::move(map));
+  BOOST_CHECK_EQUAL(map.capacity(), 0);
+  BOOST_CHECK(map.insert({2, 20}).second);
+  BOOST_CHECK_EQUAL(map.size(), 1);
+  BOOST_CHECK_EQUAL(moved.at(1), 10);
+
+  flat_hash_map<int, Widget> widgets;
+  widgets.try_emplace(1, 1);
+  BOOST_CHECK_EQUAL(widgets.at(1), Widget(1));
+}
+
+BOOST_AUTO_TEST_CASE(SubscriptOperator) {
+  flat_hash_map<std::string, int> map;
+  map["a"] = 1;
+  map["b"] += 2;
+  ++map["a"];
+
+  BOOST_CHECK_EQUAL(map.size(), 2);
+  BOOST_CHECK_EQUAL(map["a"], 2);
+  BOOST_CHECK_EQUAL(map["b"], 2);
+}
+
+BOOST_AUTO_TEST_CASE(GrowthMatchesStdUnorderedMap) {
+  flat_hash_map<int, int> map;
+  std::unordered_map<int, int> expected;
+  for (int i = 0; i != 10000; ++i) {
+    map[i * 7] = i;
+    expected[i * 7] = i;
+  }
+
+  BOOST_CHECK_EQUAL(map.size(), expected.size());
+  BOOST_CHECK(map.load_factor() <= 0.875);
+  for (auto &[key, value] : expected)
+    BOOST_CHECK_EQUAL(map.at(key), value);
+  BOOST_CHECK(!map.contains(1));
+
+  size_t visited = 0;
+  for (auto &kv : map) {
+    BOOST_CHECK_EQUAL(expected.at(kv.first), kv.second);
+    ++visited;
+  }
+  BOOST_CHECK_EQUAL(visited, expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(Erase) {
+  flat_hash_map<int, int> map;
+  for (int i = 0; i != 1000; ++i)
+    map[i] = i;
+
+  for (int i = 0; i != 1000; i += 2)
+    BOOST_CHECK_EQUAL(map.erase(i), 1);
+  BOOST_CHECK_EQUAL(map.erase(0), 0);
+
+  BOOST_CHECK_EQUAL(map.size(), 500);
+  for (int i = 0; i != 1000; ++i)
+    BOOST_CHECK_EQUAL(map.contains(i), i % 2 == 1);
+
+  auto it = map.find(1);
+  it = map.erase(it);
+  BOOST_CHECK(!map.contains(1));
+  BOOST_CHECK_EQUAL(map.size(), 499);
+}
+
+BOOST_AUTO_TEST_CASE(EraseInsertChurn_ReusesTombstones) {
+  flat_hash_map<int, int> map;
+  map.reserve(100);
+  size_t capacity = map.capacity();
+
+  // the live size stays small, so tombstones are recycled instead of growing the table
+  for (int i = 0; i != 100000; ++i) {
+    map[i] = i;
+    map.erase(i - 50);
+  }
+  BOOST_CHECK_EQUAL(map.size(), 50);
+  BOOST_CHECK_EQUAL(map.capacity(), capacity);
+  for (int i = 100000 - 50; i != 100000; ++i)
+    BOOST_CHECK(map.contains(i));
+}
+
+BOOST_AUTO_TEST_CASE(ReserveAndBulkInsert) {
+  std::vector<std::pair<int, int>> values;
+  for (int i = 0; i != 1000; ++i)
+    values.push_back({i, -i});
+
+  flat_hash_map<int, int> map;
+  map.reserve(1000);
+  size_t capacity = map.capacity();
+  BOOST_CHECK(capacity * 7 / 8 >= 1000);
+
+  map.insert(values.begin(), values.end());
+  BOOST_CHECK_EQUAL(map.size(), 1000);
+  BOOST_CHECK_EQUAL(map.capacity(), capacity); // no rehash after reserve
+  BOOST_CHECK_EQUAL(map.at(999), -999);
+}
+
+BOOST_AUTO_TEST_CASE(HeterogeneousLookup) {
+  flat_hash_map<std::string, int, string_hash, string_equal> map;
+  map["alpha"] = 1;
+  map["beta"] = 2;
+
+  std::string_view key = "beta";
+  BOOST_CHECK(map.contains(key));
+  BOOST_CHECK_EQUAL(map.find(key)->second, 2);
+  BOOST_CHECK(map.find(std::string_view("gamma")) == map.end());
+  BOOST_CHECK_EQUAL(map.erase(std::string_view("alpha")), 1);
+  BOOST_CHECK_EQUAL(map.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove) {
+  flat_hash_map<std::string, std::string> map;
+  for (int i = 0; i != 100; ++i)
+    map[std::to_string(i)] = std::string(20, char('a' + i % 26));
+
+  flat_hash_map<std::string, std::string> copied(map);
+  map["0"] = "changed";
+  BOOST_CHECK_EQUAL(copied.size(), 100);
+  BOOST_CHECK_EQUAL(copied["0"], std::string(20, 'a'));
+
+  flat_hash_map<std::string, std::string> moved(std::move(map));
+  BOOST_CHECK_EQUAL(moved.size(), 100);
+  BOOST_CHECK_EQUAL(moved["0"], "changed");
+  BOOST_CHECK(map.empty());
+
+  map = copied;
+  BOOST_CHECK_EQUAL(map.size(), 100);
+  copied = std::move(moved);
+  BOOST_CHECK_EQUAL(copied["0"], "changed");
+}
+
+BOOST_AUTO_TEST_CASE(NonTrivialValues_Rehash) {
+  flat_hash_map<int, Widget> map;
+  for (int i = 0; i != 40; ++i)
+    if (i != 43)
+      map.try_emplace(i, i);
+
+  BOOST_CHECK_EQUAL(map.size(), 40);
+  BOOST_CHECK_EQUAL(map.at(39), Widget(39));
+  BOOST_CHECK_THROW(map.try_emplace(100, 43), std::invalid_argument);
+  BOOST_CHECK_EQUAL(map.size(), 40);
+  BOOST_CHECK(!map.contains(100));
+}
+
+BOOST_AUTO_TEST_CASE(Clear) {
+  flat_hash_map<int, std::string> map;
+  for (int i = 0; i != 100; ++i)
+    map[i] = "x";
+  size_t capacity = map.capacity();
+
+  map.clear();
+  BOOST_CHECK(map.empty());
+  BOOST_CHECK_EQUAL(map.capacity(), capacity);
+  BOOST_CHECK(map.begin() == map.end());
+  map[5] = "y";
+  BOOST_CHECK_EQUAL(map.at(5), "y");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+#include "./../benchmark.cpp"
+#include "lockfree_list.cpp"
+
+#include <cstdlib>
+#include <forward_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+mixed set workload on a sorted list: every thread draws random keys from a fixed range
+and runs contains / insert / remove on them in a given mix, lockfree_list against a
+sorted std::forward_list behind a std::mutex, for 1 to 64 threads
+usage: ./bench_lockfree [operations per thread] [key range]
+*/
+
+class mutex_list {
+public:
+  bool contains(int key) {
+    std::lock_guard<std::mutex> lk(m_);
+    auto prev = lower_bound(key);
+    auto it = std::next(prev);
+    return it != list_.end() && *it == key;
+  }
+
+  bool insert(int key) {
+    std::lock_guard<std::mutex> lk(m_);
+    auto prev = lower_bound(key);
+    auto it = std::next(prev);
+    if (it != list_.end() && *it == key)
+      return false;
+    list_.insert_after(prev, key);
+    return true;
+  }
+
+  bool remove(int key) {
+    std::lock_guard<std::mutex> lk(m_);
+    auto prev = lower_bound(key);
+    auto it = std::next(prev);
+    if (it == list_.end() || *it != key)
+      return false;
+    list_.erase_after(prev);
+    return true;
+  }
+
+private:
+  // the last position before the first element not less than key
+  std::forward_list<int>::iterator lower_bound(int key) {
+    auto prev = list_.before_begin();
+    for (auto it = list_.begin(); it != list_.end() && *it < key; ++it)
+      prev = it;
+    return prev;
+  }
+
+  std::forward_list<int> list_;
+  std::mutex m_;
+};
+
+template <typename Set>
+static double run(int threads, size_t ops, int keys, unsigned read_percent) {
+  Set set;
+  for (int key = 0; key < keys; key += 2)
+    set.insert(key);
+
+  return time_it([&] {
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+      workers.emplace_back([&, t] {
+        uint64_t x = 0x9e3779b97f4a7c15ull * (t + 1);
+        size_t hits = 0;
+        for (size_t i = 0; i != ops; ++i) {
+          x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+          int key = int(x % keys);
+          unsigned roll = unsigned(x >> 40) % 100;
+          if (roll < read_percent)
+            hits += set.contains(key);
+          else if (roll % 2 == 0)
+            hits += set.insert(key);
+          else
+            hits += set.remove(key);
+        }
+        do_not_optimize(hits);
+      });
+    for (std::thread &w : workers)
+      w.join();
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50'000;
+  int keys = argc > 2 ? std::atoi(argv[2]) : 512;
+
+  std::printf("%zu operations per thread on keys [0, %d), %u hardware threads (ns per op)\n", ops,
+              keys, std::thread::hardware_concurrency());
+  for (unsigned read_percent : {90u, 50u}) {
+    std::printf("%u%% contains, the rest split between insert and remove\n", read_percent);
+    std::printf("%-8s %14s %14s\n", "threads", "lockfree", "mutex");
+    for (int threads = 1; threads <= 64; threads *= 2) {
+      double lockfree = run<lockfree_list<int>>(threads, ops, keys, read_percent);
+      double locked = run<mutex_list>(threads, ops, keys, read_percent);
+      double total = double(ops) * threads;
+      std::printf("%-8d %14.2f %14.2f\n", threads, lockfree / total * 1e9, locked / total * 1e9);
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#include "./../benchmark.cpp"
+#include "forward_list.cpp"
+#include "slab_allocator.cpp"
+
+#include <cstdlib>
+#include <vector>
+
+/*
+forward_list nodes from std::allocator (one new/delete each) against slab_allocator:
+building a list, walking it, churning at the front, and walking a list whose nodes were
+allocated interleaved with other heap traffic, the way a long-lived list ends up
+usage: ./bench_slab [elements]
+*/
+
+template <typename List> static void row(const char *name, size_t n) {
+  double build = best_of(3, [&] {
+    List list;
+    for (size_t i = 0; i != n; ++i)
+      list.push_back(i);
+    do_not_optimize(list.front());
+  });
+
+  List list;
+  for (size_t i = 0; i != n; ++i)
+    list.push_back(i);
+  double walk = best_of(3, [&] {
+    uint64_t sum = 0;
+    for (uint64_t val : list)
+      sum += val;
+    do_not_optimize(sum);
+  });
+
+  double churn = best_of(3, [&] {
+    for (size_t i = 0; i != n; ++i) {
+      list.pop_front();
+      list.push_front(i);
+    }
+    do_not_optimize(list.front());
+  });
+
+  // every node is allocated between two unrelated blocks, which std::allocator scatters
+  List scattered;
+  {
+    std::vector<std::vector<char>> noise;
+    for (size_t i = 0; i != n; ++i) {
+      scattered.push_back(i);
+      if (i % 2 == 0)
+        noise.emplace_back(48);
+    }
+  }
+  double walk_scattered = best_of(3, [&] {
+    uint64_t sum = 0;
+    for (uint64_t val : scattered)
+      sum += val;
+    do_not_optimize(sum);
+  });
+
+  double clear = time_it([&] { list.clear(); });
+
+  std::printf("%-16s %10.2f %10.2f %10.2f %12.2f %10.2f\n", name, build / n * 1e9, walk / n * 1e9,
+              churn / n * 1e9, walk_scattered / n * 1e9, clear / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  std::printf("%zu uint64_t elements, ns per element\n", n);
+  std::printf("%-16s %10s %10s %10s %12s %10s\n", "", "push_back", "iterate", "pop+push",
+              "iterate(mix)", "clear");
+  row<forward_list<uint64_t>>("std::allocator", n);
+  row<forward_list<uint64_t, slab_allocator<uint64_t>>>("slab_allocator", n);
+}
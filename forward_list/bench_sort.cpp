@@ -0,0 +1,64 @@
+#include "./../benchmark.cpp"
+#include "forward_list.cpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+/*
+sorting a forward_list of random keys: the old way (copy into a vector, sort, rebuild the
+list, twice the memory and a new node per element) against sort() relinking the nodes in
+place; plus merge() of two sorted halves and unique() of the sorted result, for 10^3 to
+10^7 elements
+usage: ./bench_sort [largest size]
+*/
+
+static forward_list<uint32_t> random_list(size_t n) {
+  forward_list<uint32_t> list;
+  for (size_t i = 0; i != n; ++i)
+    list.push_back(uint32_t(bench_rng()() % (n / 2 + 1)));
+  return list;
+}
+
+static void row(size_t n) {
+  const int repeat = n <= 100'000 ? 5 : 1;
+
+  double copy_sort = 0;
+  double relink_sort = 0;
+  double merge = 0;
+  double unique = 0;
+  for (int r = 0; r != repeat; ++r) {
+    forward_list<uint32_t> list = random_list(n);
+    copy_sort += time_it([&] {
+      std::vector<uint32_t> tmp;
+      tmp.reserve(list.size());
+      for (uint32_t val : list)
+        tmp.push_back(val);
+      std::sort(tmp.begin(), tmp.end());
+      forward_list<uint32_t> sorted;
+      for (uint32_t val : tmp)
+        sorted.push_back(val);
+      swap(list, sorted);
+    });
+
+    forward_list<uint32_t> other = random_list(n);
+    relink_sort += time_it([&] { other.sort(); });
+
+    forward_list<uint32_t> half = random_list(n / 2);
+    half.sort();
+    merge += time_it([&] { other.merge(half); });
+    unique += time_it([&] { do_not_optimize(other.unique()); });
+  }
+
+  std::printf("%-10zu %12.1f %12.1f %12.1f %12.1f\n", n, copy_sort / repeat / n * 1e9,
+              relink_sort / repeat / n * 1e9, merge / repeat / n * 1e9, unique / repeat / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t largest = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+  std::printf("ns per element\n%-10s %12s %12s %12s %12s\n", "elements", "copy+sort", "sort()",
+              "merge(n/2)", "unique()");
+  for (size_t n = 1000; n <= largest; n *= 10)
+    row(n);
+}
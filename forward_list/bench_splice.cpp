@@ -0,0 +1,89 @@
+#include "./../benchmark.cpp"
+#include "forward_list.cpp"
+
+#include <cstdlib>
+#include <vector>
+
+/*
+handing a batch of work items out in chunks and gathering them back, the way a dispatcher
+feeds worker threads: copying each chunk into a list of its own (push_back + pop_front,
+a new node per element) against split_after() cutting it off and append() joining the
+chunks again, for chunk sizes 16 to 4096
+usage: ./bench_splice [elements]
+*/
+
+struct job {
+  uint64_t id_;
+  uint64_t payload_[3];
+};
+
+static forward_list<job> batch(size_t n) {
+  forward_list<job> list;
+  for (size_t i = 0; i != n; ++i)
+    list.push_back(job{i, {i, i, i}});
+  return list;
+}
+
+/* chunks of up to k jobs, each copied out of work element by element */
+static std::vector<forward_list<job>> copy_out(forward_list<job> &work, size_t k) {
+  std::vector<forward_list<job>> chunks;
+  while (!work.empty()) {
+    chunks.emplace_back();
+    for (size_t i = 0; i != k && !work.empty(); ++i) {
+      chunks.back().push_back(work.front());
+      work.pop_front();
+    }
+  }
+  return chunks;
+}
+
+static void copy_in(forward_list<job> &work, std::vector<forward_list<job>> &chunks) {
+  for (forward_list<job> &chunk : chunks)
+    for (const job &item : chunk)
+      work.push_back(item);
+  chunks.clear();
+}
+
+/* chunks of up to k jobs, cut off the front of work */
+static std::vector<forward_list<job>> split_out(forward_list<job> &work, size_t k) {
+  std::vector<forward_list<job>> chunks;
+  while (!work.empty()) {
+    size_t take = k < work.size() ? k : work.size();
+    forward_list<job>::iterator last = work.before_begin();
+    for (size_t i = 0; i != take; ++i)
+      ++last;
+    forward_list<job> rest = work.split_after(last, take);
+    chunks.push_back(std::move(work));
+    work = std::move(rest);
+  }
+  return chunks;
+}
+
+static void split_in(forward_list<job> &work, std::vector<forward_list<job>> &chunks) {
+  for (forward_list<job> &chunk : chunks)
+    work.append(std::move(chunk));
+  chunks.clear();
+}
+
+template <typename Out, typename In> static double round_trip(size_t n, size_t k, Out out, In in) {
+  forward_list<job> work = batch(n);
+  return best_of(3, [&] {
+    std::vector<forward_list<job>> chunks = out(work, k);
+    do_not_optimize(chunks.size());
+    in(work, chunks);
+    do_not_optimize(work.size());
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  std::printf("%zu jobs of %zu bytes handed out in chunks and gathered back, ns per job\n", n,
+              sizeof(job));
+  std::printf("%-8s %12s %12s\n", "chunk", "copy", "split");
+  for (size_t k = 16; k <= 4096; k *= 4) {
+    double copy = round_trip(n, k, copy_out, copy_in);
+    double split = round_trip(n, k, split_out, split_in);
+    std::printf("%-8zu %12.2f %12.2f\n", k, copy / n * 1e9, split / n * 1e9);
+  }
+}
@@ -0,0 +1,67 @@
+#include "./../benchmark.cpp"
+#include "forward_list.cpp"
+#include "unrolled_list.cpp"
+
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+/*
+forward_list (one element per node) against unrolled_list (a node per 256 bytes and per
+4 KiB): building with push_back, walking the list, and one pass that inserts after every
+4th element; the walk runs over a list built among other heap traffic, which scatters
+forward_list's nodes the way a long-lived list ends up
+usage: ./bench_unrolled [elements]
+*/
+
+template <typename List> static void row(const char *name, size_t n) {
+  double build = best_of(3, [&] {
+    List list;
+    for (size_t i = 0; i != n; ++i)
+      list.push_back(i);
+    do_not_optimize(list.front());
+  });
+
+  List list;
+  {
+    std::vector<std::vector<char>> noise;
+    for (size_t i = 0; i != n; ++i) {
+      list.push_back(i);
+      if (i % 2 == 0)
+        noise.emplace_back(48);
+    }
+  }
+  double walk = best_of(3, [&] {
+    uint64_t sum = 0;
+    for (uint64_t val : list)
+      sum += val;
+    do_not_optimize(sum);
+  });
+
+  double insert = time_it([&] {
+    size_t i = 0;
+    for (auto it = list.begin(); it != list.end(); ++it)
+      if (++i % 4 == 0) {
+        // forward_list iterators stay valid, unrolled_list returns the new position
+        if constexpr (std::is_void_v<decltype(list.insert_after(it, i))>) {
+          list.insert_after(it, i);
+          ++it;
+        } else {
+          it = list.insert_after(it, i);
+        }
+      }
+  });
+
+  std::printf("%-22s %10.2f %10.2f %12.2f\n", name, build / n * 1e9, walk / n * 1e9,
+              insert / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  std::printf("%zu uint64_t elements, ns per element\n", n);
+  std::printf("%-22s %10s %10s %12s\n", "", "push_back", "iterate", "insert pass");
+  row<forward_list<uint64_t>>("forward_list", n);
+  row<unrolled_list<uint64_t>>("unrolled_list (256 B)", n);
+  row<unrolled_list<uint64_t, (4096 - 16) / sizeof(uint64_t)>>("unrolled_list (4 KiB)", n);
+}
@@ -1,7 +1,20 @@
+#pragma once
+
+#include "./../memory_accounting/memory_accounting.cpp"
+
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <utility>
 
-template <typename T> class forward_list {
+/*
+singly linked list with a sentinel head node
+
+nodes come from Alloc rebound to the node type, one at a time; std::allocator gives one
+new/delete per element, slab_allocator (slab_allocator.cpp) carves nodes out of large slabs
+and releases the slabs as the list empties
+*/
+template <typename T, typename Alloc = std::allocator<T>> class forward_list {
 private:
   struct Node {
     T data_;
@@ -10,6 +23,9 @@ private:
     Node(const T &data = T(), Node *next = nullptr) : data_(data), next_(next) {}
   };
 
+  using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAlloc>;
+
 public:
   class iterator {
   public:
@@ -44,11 +60,20 @@ public:
 
   iterator begin() const { return head_->next_; }
   iterator end() const { return nullptr; }
+  /* the sentinel, for inserting, splicing or splitting at the front */
+  iterator before_begin() const { return head_; }
 
   forward_list() : head_(construct()), tail_(head_), size_(0) {}
 
+  explicit forward_list(memory_tag tag) : tag_(tag), head_(construct()), tail_(head_), size_(0) {}
+
+  explicit forward_list(const Alloc &alloca, memory_tag tag = memory_tag())
+      : tag_(tag), alloca_(alloca), head_(construct()), tail_(head_), size_(0) {}
+
   // copy constructor
-  forward_list(const forward_list &oth) : head_(construct()), tail_(head_), size_(0) {
+  forward_list(const forward_list &oth)
+      : tag_(oth.tag_), alloca_(NodeTraits::select_on_container_copy_construction(oth.alloca_)),
+        head_(construct()), tail_(head_), size_(0) {
     uninitialized_copy(oth.head_, head_);
   }
 
@@ -64,7 +89,8 @@ public:
   }
 
   // move constructor
-  forward_list(forward_list &&oth) noexcept : head_(oth.head_), tail_(oth.tail_), size_(oth.size_) {
+  forward_list(forward_list &&oth) noexcept
+      : tag_(oth.tag_), alloca_(oth.alloca_), head_(oth.head_), tail_(oth.tail_), size_(oth.size_) {
     oth.head_ = oth.tail_ = nullptr;
     oth.size_ = 0;
   }
@@ -140,17 +166,155 @@ public:
     ++size_;
   }
 
+  /* destroys every element, the sentinel stays */
+  void clear() noexcept {
+    destroy_all(head_->next_);
+    head_->next_ = nullptr;
+    tail_ = head_;
+    size_ = 0;
+  }
+
   size_t size() const { return size_; }
   bool empty() const { return 0 == size_; }
 
-  friend void swap(forward_list<T> &lhs, forward_list<T> &rhs) noexcept {
+  Alloc get_allocator() const { return Alloc(alloca_); }
+
+  friend void swap(forward_list &lhs, forward_list &rhs) noexcept {
     using std::swap;
+    swap(lhs.alloca_, rhs.alloca_);
     swap(lhs.head_, rhs.head_);
     swap(lhs.tail_, rhs.tail_);
     swap(lhs.size_, rhs.size_);
+    swap(lhs.tag_, rhs.tag_);
+  }
+
+  /*
+  stable bottom-up merge sort that relinks the nodes, no element is copied or allocated.
+  runs of 1, 2, 4, ... nodes wait in a fixed array of 64 bins, so the extra space is O(1)
+  and each new node is merged while its neighbours are still in cache. if comp throws,
+  every element is still in the list, in unspecified order
+  */
+  template <typename Compare = std::less<>> void sort(Compare comp = Compare()) {
+    if (size_ < 2)
+      return;
+
+    run bins[64]; // bins[i] is empty or a sorted run of 2^i nodes, higher bins hold earlier nodes
+    size_t used = 0;
+    run carry;
+    Node *rest = head_->next_;
+    try {
+      while (rest != nullptr) {
+        carry = run{rest, rest};
+        rest = rest->next_;
+        carry.tail_->next_ = nullptr;
+
+        size_t i = 0;
+        for (; i != used && bins[i].head_ != nullptr; ++i) {
+          merge_runs(bins[i], carry, comp);
+          carry = std::exchange(bins[i], run());
+        }
+        bins[i] = std::exchange(carry, run());
+        if (i == used)
+          ++used;
+      }
+      for (size_t i = 1; i != used; ++i)
+        merge_runs(bins[i], bins[i - 1], comp);
+    } catch (...) {
+      // a failed merge leaves its nodes in the bin, put the bins back one after the other
+      Node *chain = rest;
+      for (size_t i = 0; i != used; ++i)
+        if (bins[i].head_ != nullptr) {
+          bins[i].tail_->next_ = chain;
+          chain = bins[i].head_;
+        }
+      head_->next_ = chain;
+      for (tail_ = head_; tail_->next_ != nullptr; tail_ = tail_->next_)
+        ;
+      throw;
+    }
+    head_->next_ = bins[used - 1].head_;
+    tail_ = bins[used - 1].tail_;
+  }
+
+  /*
+  moves every node of the sorted list oth into this sorted list, keeping it sorted; among
+  equal elements the ones already here come first. nodes are relinked, not copied, so the
+  allocators must compare equal. if comp throws, every element of both lists ends up in
+  this one, in unspecified order
+  */
+  template <typename Compare = std::less<>> void merge(forward_list &oth, Compare comp = Compare()) {
+    if (&oth == this || oth.empty())
+      return;
+    if (!(alloca_ == oth.alloca_))
+      throw "merging lists with unequal allocators";
+
+    run mine{head_->next_, empty() ? nullptr : tail_};
+    run theirs{oth.head_->next_, oth.tail_};
+    try {
+      merge_runs(mine, theirs, comp);
+    } catch (...) {
+      adopt(oth, mine);
+      throw;
+    }
+    adopt(oth, mine);
+  }
+
+  /* erases the elements pred accepts, returns how many; the nodes are freed together at the end */
+  template <typename Predicate> size_t remove_if(Predicate pred) {
+    Node *removed = nullptr;
+    size_t count = 0;
+    Node *prev = head_;
+    try {
+      while (Node *node = prev->next_) {
+        if (pred(node->data_)) {
+          prev->next_ = node->next_;
+          node->next_ = std::exchange(removed, node);
+          ++count;
+        } else {
+          prev = node;
+        }
+      }
+    } catch (...) {
+      // the tail is only unlinked in the last step, after which pred is not called again
+      release(removed, count);
+      throw;
+    }
+    tail_ = prev;
+    release(removed, count);
+    return count;
+  }
+
+  /* erases every element equal (by pred) to the one kept before it, returns how many */
+  template <typename BinaryPredicate = std::equal_to<>>
+  size_t unique(BinaryPredicate pred = BinaryPredicate()) {
+    if (size_ < 2)
+      return 0;
+
+    Node *removed = nullptr;
+    size_t count = 0;
+    Node *kept = head_->next_;
+    try {
+      while (Node *node = kept->next_) {
+        if (pred(kept->data_, node->data_)) {
+          kept->next_ = node->next_;
+          node->next_ = std::exchange(removed, node);
+          ++count;
+        } else {
+          kept = node;
+        }
+      }
+    } catch (...) {
+      release(removed, count);
+      throw;
+    }
+    tail_ = kept;
+    release(removed, count);
+    return count;
   }
 
   void reverse() {
+    if (empty())
+      return;
     tail_ = head_->next_;
 
     Node *tmp = nullptr;
@@ -164,13 +328,173 @@ public:
     head_->next_ = tmp;
   }
 
+  /*
+  splicing relinks nodes from oth into this list and splitting relinks them into a new one;
+  nothing is copied or allocated (but the new list's sentinel) and iterators stay valid,
+  now pointing into the list that holds the node. nodes change lists only between lists
+  whose allocators compare equal
+  */
+
+  /* moves every element of oth right after pos, O(1) */
+  void splice_after(const iterator pos, forward_list &oth) {
+    if (&oth == this || oth.empty())
+      return;
+    transfer(pos.ptr_, oth, oth.head_, oth.tail_, oth.size_);
+  }
+
+  void splice_after(const iterator pos, forward_list &&oth) { splice_after(pos, oth); }
+
+  /* moves the element right after it in oth (which may be this list) right after pos, O(1) */
+  void splice_after(const iterator pos, forward_list &oth, const iterator it) {
+    Node *node = it.ptr_->next_;
+    if (node == nullptr)
+      throw "no element after iterator";
+    transfer(pos.ptr_, oth, it.ptr_, node, 1);
+  }
+
+  /*
+  moves the elements in (first, last) of oth right after pos, which must not be one of
+  them; O(number moved), the nodes are walked once to count them and find the last
+  */
+  void splice_after(const iterator pos, forward_list &oth, const iterator first, const iterator last) {
+    if (first.ptr_->next_ == last.ptr_)
+      return;
+    size_t n = 1;
+    Node *end = first.ptr_->next_;
+    for (; end->next_ != last.ptr_; end = end->next_)
+      ++n;
+    transfer(pos.ptr_, oth, first.ptr_, end, n);
+  }
+
+  /* moves every element of oth to the end of this list, O(1) */
+  void append(forward_list &&oth) { splice_after(iterator(tail_), oth); }
+
+  /*
+  moves the elements after pos into a new list and returns it; kept is the number of
+  elements up to and including pos (0 for before_begin()), which callers that walked to
+  pos already know, O(1)
+  */
+  forward_list split_after(const iterator pos, size_t kept) {
+    if (kept > size_)
+      throw "split position past the end";
+    forward_list out(get_allocator(), tag_);
+    if (pos.ptr_->next_ != nullptr)
+      out.transfer(out.head_, *this, pos.ptr_, tail_, size_ - kept);
+    return out;
+  }
+
+  /* the same, counting the elements up to pos first: O(position of pos) */
+  forward_list split_after(const iterator pos) {
+    size_t kept = 0;
+    for (Node *node = head_; node != pos.ptr_; node = node->next_)
+      ++kept;
+    return split_after(pos, kept);
+  }
+
   friend class iterator;
 
 private:
-  Node *construct(const T &val = T(), Node *next = nullptr) { return new Node(val, next); }
-  void destroy(Node *ptr) { delete ptr; }
+  /* a null-terminated chain of nodes, both ends null when empty */
+  struct run {
+    Node *head_ = nullptr;
+    Node *tail_ = nullptr;
+  };
+
+  /*
+  merges the sorted run b into the sorted run a, a's elements first among equals; b is
+  left empty. if comp throws, a holds the nodes of both runs and b is left empty
+  */
+  template <typename Compare> static void merge_runs(run &a, run &b, Compare &comp) {
+    Node *x = a.head_, *y = b.head_;
+    Node *first = nullptr;
+    Node **link = &first;
+    Node *last = nullptr;
+    try {
+      while (x != nullptr && y != nullptr) {
+        Node *&taken = comp(y->data_, x->data_) ? y : x;
+        *link = last = taken;
+        link = &taken->next_;
+        taken = taken->next_;
+      }
+    } catch (...) {
+      // what is left of a, then what is left of b, go behind the merged part
+      *link = x;
+      a.tail_->next_ = y;
+      a = run{first, b.tail_};
+      b = run();
+      throw;
+    }
+    *link = x != nullptr ? x : y;
+    a = run{first, x != nullptr ? a.tail_ : y != nullptr ? b.tail_ : last};
+    b = run();
+  }
+
+  /* frees a chain of n nodes already unlinked from the list */
+  void release(Node *chain, size_t n) noexcept {
+    size_ -= n;
+    destroy_all(chain);
+  }
+
+  /* makes chain, all of this list's nodes and all of oth's, the contents; oth is left empty */
+  void adopt(forward_list &oth, run chain) noexcept {
+    head_->next_ = chain.head_;
+    tail_ = chain.tail_;
+    take_over(oth, oth.size_);
+    oth.head_->next_ = nullptr;
+    oth.tail_ = oth.head_;
+  }
+
+  /*
+  unlinks the n nodes after before up to last from oth and links them in after pos, which
+  must not be one of them; oth may be this list
+  */
+  void transfer(Node *pos, forward_list &oth, Node *before, Node *last, size_t n) {
+    if (pos == before || pos == last)
+      return; // already in place
+    if (&oth != this && !(alloca_ == oth.alloca_))
+      throw "splicing lists with unequal allocators";
+
+    Node *first = before->next_;
+    before->next_ = last->next_;
+    if (oth.tail_ == last)
+      oth.tail_ = before;
+    last->next_ = pos->next_;
+    pos->next_ = first;
+    if (tail_ == pos)
+      tail_ = last;
+    take_over(oth, n);
+  }
+
+  /* n nodes of oth have been relinked into this list */
+  void take_over(forward_list &oth, size_t n) noexcept {
+    if (tag_ != oth.tag_) {
+      // the bytes move to this list's tag
+      oth.tag_.on_deallocate(n * sizeof(Node));
+      tag_.on_allocate(n * sizeof(Node));
+    }
+    oth.size_ -= n;
+    size_ += n;
+  }
+
+  Node *construct(const T &val = T(), Node *next = nullptr) {
+    Node *node = NodeTraits::allocate(alloca_, 1);
+    try {
+      NodeTraits::construct(alloca_, node, val, next);
+    } catch (...) {
+      NodeTraits::deallocate(alloca_, node, 1);
+      throw;
+    }
+    tag_.on_allocate(sizeof(Node));
+    return node;
+  }
+
+  void destroy(Node *ptr) noexcept {
+    tag_.on_deallocate(sizeof(Node));
+    NodeTraits::destroy(alloca_, ptr);
+    NodeTraits::deallocate(alloca_, ptr, 1);
+  }
 
-  void destroy_all(Node *src_begin) {
+  void destroy_all(Node *src_begin) noexcept {
     Node *node_to_delete = src_begin;
 
     while (node_to_delete) {
@@ -199,6 +523,8 @@ private:
   push() - node->next;
   pop() - tail
   */
+  [[no_unique_address]] memory_tag tag_;     // accounts the nodes, declared first for construct()
+  [[no_unique_address]] NodeAlloc alloca_; // allocates the nodes, declared before head_ too
   Node *head_; // points to a sentinel node
   Node *tail_; // points to thse last node
   size_t size_;
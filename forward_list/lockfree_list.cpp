@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/*
+hazard pointers for nodes of type Node
+
+a thread that is about to dereference a shared node publishes its address in one of its
+Slots hazard slots and re-reads the link it came from; if the link still points to the
+node, no thread can free it until the slot is cleared. a removed node is retired instead
+of deleted: it goes on the thread's retired list, and once that list is long enough the
+thread frees every retired node that no hazard slot names. reclamation is thus bounded
+(at most about twice the number of hazard slots stay pending per thread) and never waits.
+
+each thread takes a record of slots from the domain on first use and gives it back when it
+exits; the next thread to take the record also inherits the nodes it still had retired.
+*/
+template <typename Node, size_t Slots>
+class hazard_domain
+{
+public:
+    /* the hazard slots of one thread, only that thread writes them */
+    class alignas(64) record
+    {
+    public:
+        /*
+        loads the pointer held in src into hazard slot `slot` and returns the word read, with
+        whatever mark bits it carried; the node is safe to read until the slot is overwritten
+        */
+        uintptr_t protect(size_t slot, const std::atomic<uintptr_t> &src, uintptr_t mark_mask)
+        {
+            uintptr_t word = src.load(std::memory_order_acquire);
+            for (;;)
+            {
+                // seq_cst orders the publication before the re-read, pairs with the scan in reclaim()
+                hazards_[slot].store(reinterpret_cast<Node *>(word & ~mark_mask), std::memory_order_seq_cst);
+                uintptr_t again = src.load(std::memory_order_seq_cst);
+                if (again == word)
+                    return word;
+                word = again;
+            }
+        }
+
+        void clear()
+        {
+            for (std::atomic<Node *> &hazard : hazards_)
+                hazard.store(nullptr, std::memory_order_release);
+        }
+
+    private:
+        friend class hazard_domain;
+
+        std::atomic<Node *> hazards_[Slots] = {};
+        std::atomic<bool> active_{true};
+        record *next_ = nullptr;      // immutable once the record is published
+        std::vector<Node *> retired_; // owner only
+    };
+
+    hazard_domain() = default;
+    hazard_domain(const hazard_domain &) = delete;
+    hazard_domain &operator=(const hazard_domain &) = delete;
+
+    // no thread is left to read a node
+    ~hazard_domain()
+    {
+        for (record *rec = records_.load(std::memory_order_relaxed); rec != nullptr;)
+        {
+            for (Node *node : rec->retired_)
+                delete node;
+            delete std::exchange(rec, rec->next_);
+        }
+    }
+
+    /* the calling thread's record, taken from the domain on first use */
+    record &local()
+    {
+        // one per thread and domain type, domains of a type are process-wide singletons
+        static thread_local owner self;
+        if (self.record_ == nullptr)
+        {
+            self.domain_ = this;
+            self.record_ = acquire_record();
+        }
+        return *self.record_;
+    }
+
+    /* node is unlinked, it is deleted once no hazard slot names it; rec is local() */
+    void retire(record &rec, Node *node)
+    {
+        rec.retired_.push_back(node);
+        if (rec.retired_.size() >= 2 * Slots * records_count_.load(std::memory_order_relaxed) + 16)
+            reclaim(rec);
+    }
+
+    /* nodes retired by every thread and not yet deleted, for tests; call with no thread active */
+    size_t pending() const
+    {
+        size_t n = 0;
+        for (record *rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next_)
+            n += rec->retired_.size();
+        return n;
+    }
+
+private:
+    /* gives the record back when its thread exits */
+    struct owner
+    {
+        hazard_domain *domain_ = nullptr;
+        record *record_ = nullptr;
+
+        ~owner()
+        {
+            if (record_ == nullptr)
+                return;
+            record_->clear();
+            domain_->reclaim(*record_);
+            record_->active_.store(false, std::memory_order_release);
+        }
+    };
+
+    record *acquire_record()
+    {
+        for (record *rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next_)
+        {
+            bool expected = false;
+            if (!rec->active_.load(std::memory_order_relaxed) &&
+                rec->active_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return rec;
+        }
+
+        record *rec = new record;
+        rec->next_ = records_.load(std::memory_order_relaxed);
+        while (!records_.compare_exchange_weak(rec->next_, rec, std::memory_order_release,
+                                               std::memory_order_relaxed))
+            ;
+        records_count_.fetch_add(1, std::memory_order_relaxed);
+        return rec;
+    }
+
+    void reclaim(record &rec)
+    {
+        std::vector<Node *> hazards;
+        for (record *r = records_.load(std::memory_order_acquire); r != nullptr; r = r->next_)
+            for (std::atomic<Node *> &hazard : r->hazards_)
+                if (Node *node = hazard.load(std::memory_order_seq_cst))
+                    hazards.push_back(node);
+        std::sort(hazards.begin(), hazards.end());
+
+        // nodes still protected stay for the next round
+        auto kept = std::partition(rec.retired_.begin(), rec.retired_.end(), [&](Node *node)
+                                   { return std::binary_search(hazards.begin(), hazards.end(), node); });
+        for (auto it = kept; it != rec.retired_.end(); ++it)
+            delete *it;
+        rec.retired_.erase(kept, rec.retired_.end());
+    }
+
+    std::atomic<record *> records_{nullptr};
+    std::atomic<size_t> records_count_{0};
+};
+
+/*
+lock-free sorted set as a singly linked list (Harris, with Michael's hazard pointers)
+
+the layout follows forward_list: a sentinel head node followed by the elements, here kept
+in Compare order without duplicates. a node is removed in two steps: first its next link
+is marked (the low bit of the pointer), which deletes it logically and freezes the link
+so no insertion can land after it, then a CAS on its predecessor unlinks it. any thread
+that runs into a marked node while searching helps unlink it, so no thread ever waits.
+
+contains(), insert() and remove() are lock-free. traversals protect the predecessor, the
+current and the next node with three hazard pointers, and unlinked nodes are retired to
+the hazard domain shared by every list of this type rather than deleted, so a concurrent
+reader never touches freed memory.
+*/
+template <typename T, typename Compare = std::less<T>>
+class lockfree_list
+{
+    struct Node
+    {
+        T data_;
+        std::atomic<uintptr_t> next_; // Node * with the low bit set once the node is removed
+
+        Node(const T &data = T(), uintptr_t next = 0) : data_(data), next_(next) {}
+    };
+
+    static constexpr uintptr_t marked = 1;
+    using domain = hazard_domain<Node, 3>;
+    using hazards = typename domain::record;
+
+public:
+    explicit lockfree_list(Compare compare = Compare())
+        : head_(new Node()), compare_(std::move(compare)), size_(0) {}
+
+    lockfree_list(const lockfree_list &) = delete;
+    lockfree_list &operator=(const lockfree_list &) = delete;
+
+    // no thread may use the list any more; retired nodes belong to the domain already
+    ~lockfree_list()
+    {
+        for (Node *node = head_; node != nullptr;)
+            delete std::exchange(node, pointer(node->next_.load(std::memory_order_relaxed)));
+    }
+
+    bool contains(const T &val)
+    {
+        hazards &hp = domain_.local();
+        position pos;
+        bool found = find(hp, val, pos);
+        hp.clear();
+        return found;
+    }
+
+    /* false if an equal element is already there */
+    bool insert(const T &val)
+    {
+        hazards &hp = domain_.local();
+        Node *node = new Node(val);
+        position pos;
+        for (;;)
+        {
+            if (find(hp, val, pos))
+            {
+                hp.clear();
+                delete node;
+                return false;
+            }
+            node->next_.store(reinterpret_cast<uintptr_t>(pos.cur_), std::memory_order_relaxed);
+            uintptr_t expected = reinterpret_cast<uintptr_t>(pos.cur_);
+            // release publishes the node's contents to readers that follow the link
+            if (pos.prev_->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node),
+                                                   std::memory_order_release, std::memory_order_relaxed))
+                break;
+        }
+        hp.clear();
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /* false if no equal element was there */
+    bool remove(const T &val)
+    {
+        hazards &hp = domain_.local();
+        position pos;
+        for (;;)
+        {
+            if (!find(hp, val, pos))
+            {
+                hp.clear();
+                return false;
+            }
+            // marking the link removes the node logically, whoever marks it owns the removal
+            uintptr_t next = reinterpret_cast<uintptr_t>(pos.next_);
+            if (pos.cur_->next_.compare_exchange_strong(next, next | marked, std::memory_order_acq_rel,
+                                                        std::memory_order_relaxed))
+                break;
+        }
+
+        uintptr_t expected = reinterpret_cast<uintptr_t>(pos.cur_);
+        if (pos.prev_->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pos.next_),
+                                               std::memory_order_acq_rel, std::memory_order_relaxed))
+            domain_.retire(hp, pos.cur_);
+        else
+            find(hp, val, pos); // unlinks it, or somebody else already has
+        hp.clear();
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /* a snapshot, concurrent inserts and removes may change it right after */
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+    /* calls f on every element in order; no other thread may modify the list meanwhile */
+    template <typename F>
+    void for_each(F &&f) const
+    {
+        for (Node *node = pointer(head_->next_.load(std::memory_order_acquire)); node != nullptr;
+             node = pointer(node->next_.load(std::memory_order_acquire)))
+            f(static_cast<const T &>(node->data_));
+    }
+
+    /* retired nodes not yet deleted across all lists of this type; call with no thread active */
+    static size_t pending_reclamation() { return domain_.pending(); }
+
+private:
+    struct position
+    {
+        std::atomic<uintptr_t> *prev_; // link to cur_, in head_ or a protected node
+        Node *cur_;                    // first node not ordered before the value, or null
+        Node *next_;                   // cur_'s successor when cur_ is not null
+    };
+
+    static Node *pointer(uintptr_t word) { return reinterpret_cast<Node *>(word & ~marked); }
+
+    /*
+    positions pos at the first node not ordered before val, unlinking marked nodes on the
+    way; true if that node holds an equal value. cur_, next_ and the node holding prev_
+    stay protected until hp is cleared
+
+    the three hazard slots rotate roles as the walk advances instead of copying a pointer
+    from one slot to another, a copy the scan in reclaim() could miss
+    */
+    bool find(hazards &hp, const T &val, position &pos)
+    {
+    retry:
+        size_t prev_slot = 0, cur_slot = 1, next_slot = 2;
+        pos.prev_ = &head_->next_;
+        pos.cur_ = pointer(hp.protect(cur_slot, *pos.prev_, marked));
+        for (;;)
+        {
+            if (pos.cur_ == nullptr)
+                return false;
+
+            uintptr_t next = hp.protect(next_slot, pos.cur_->next_, marked);
+            pos.next_ = pointer(next);
+            // the predecessor changed or got removed itself, cur_ may be gone
+            if (pos.prev_->load(std::memory_order_acquire) != reinterpret_cast<uintptr_t>(pos.cur_))
+                goto retry;
+
+            if (!(next & marked))
+            {
+                if (!compare_(pos.cur_->data_, val))
+                    return !compare_(val, pos.cur_->data_);
+                pos.prev_ = &pos.cur_->next_;
+                // cur_ becomes the predecessor, the old predecessor's slot is free for the next node
+                std::swap(prev_slot, cur_slot);
+            }
+            else
+            {
+                // cur_ is removed, help unlink it
+                uintptr_t expected = reinterpret_cast<uintptr_t>(pos.cur_);
+                if (!pos.prev_->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(pos.next_),
+                                                        std::memory_order_acq_rel, std::memory_order_relaxed))
+                    goto retry;
+                domain_.retire(hp, pos.cur_);
+            }
+            pos.cur_ = pos.next_;
+            std::swap(cur_slot, next_slot);
+        }
+    }
+
+    static inline domain domain_;
+
+    Node *head_; // sentinel, never removed
+    [[no_unique_address]] Compare compare_;
+    std::atomic<size_t> size_;
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+pool of fixed-size slots carved out of large aligned slabs
+
+a slab is slab_bytes long and aligned to slab_bytes, with a small header at the start, so
+the slab of any slot is its address with the low bits masked off. a slab hands out slots
+first from its free list, then by bumping through the part never used yet, so a new slab
+is not touched before it is needed. every slab counts its live slots: when the last one is
+freed the whole slab goes back to the system, except that one emptied slab is kept so a
+container shrinking and growing across a slab boundary does not allocate each time.
+
+allocate() and deallocate() are O(1). slabs with free slots are kept on a list, the most
+recently freed into first, so new nodes reuse memory that is likely still in cache.
+not thread-safe.
+*/
+class slab_pool {
+  struct free_slot {
+    free_slot *next_;
+  };
+
+  struct slab {
+    slab *prev_ = nullptr;
+    slab *next_ = nullptr;
+    free_slot *free_ = nullptr; // slots given back
+    std::byte *bump_;           // first slot never handed out
+    size_t live_ = 0;
+    bool available_ = false; // on the available_ list rather than full_
+  };
+
+public:
+  /* slab_bytes must be a power of two with room for the header and at least one slot */
+  slab_pool(size_t slot_size, size_t slot_align, size_t slab_bytes = 64 * 1024)
+      : slot_align_(slot_align > alignof(free_slot) ? slot_align : alignof(free_slot)),
+        slot_size_(round_up(slot_size > sizeof(free_slot) ? slot_size : sizeof(free_slot),
+                            slot_align_)),
+        first_slot_(round_up(sizeof(slab), slot_align_)), slab_bytes_(slab_bytes) {
+    if (slab_bytes == 0 || (slab_bytes & (slab_bytes - 1)) != 0)
+      throw "slab size must be a power of two";
+    if (first_slot_ + slot_size_ > slab_bytes)
+      throw "slab too small for one slot";
+  }
+
+  slab_pool(const slab_pool &) = delete;
+  slab_pool &operator=(const slab_pool &) = delete;
+
+  // every slab goes, slots still handed out included
+  ~slab_pool() {
+    release_list(available_);
+    release_list(full_);
+  }
+
+  void *allocate() {
+    slab *s = available_;
+    if (s == nullptr)
+      s = new_slab();
+    if (s == empty_)
+      empty_ = nullptr;
+
+    void *p;
+    if (s->free_ != nullptr) {
+      p = s->free_;
+      s->free_ = s->free_->next_;
+    } else {
+      p = s->bump_;
+      s->bump_ += slot_size_;
+    }
+    ++s->live_;
+
+    if (s->free_ == nullptr && s->bump_ + slot_size_ > end_of(s))
+      move_to(s, full_, false);
+    return p;
+  }
+
+  void deallocate(void *p) noexcept {
+    slab *s = slab_of(p);
+    s->free_ = new (p) free_slot{s->free_};
+    if (s != available_)
+      move_to(s, available_, true); // most recently freed first
+
+    if (--s->live_ == 0) {
+      if (empty_ == nullptr) {
+        empty_ = s;
+      } else {
+        unlink(s);
+        ::operator delete(s, std::align_val_t(slab_bytes_));
+        --slabs_;
+      }
+    }
+  }
+
+  size_t slot_size() const noexcept { return slot_size_; }
+  size_t slot_align() const noexcept { return slot_align_; }
+  size_t slab_bytes() const noexcept { return slab_bytes_; }
+  size_t slabs() const noexcept { return slabs_; }
+
+private:
+  static size_t round_up(size_t n, size_t align) noexcept { return (n + align - 1) / align * align; }
+
+  std::byte *end_of(slab *s) const noexcept { return reinterpret_cast<std::byte *>(s) + slab_bytes_; }
+
+  slab *slab_of(void *p) const noexcept {
+    return reinterpret_cast<slab *>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(slab_bytes_ - 1));
+  }
+
+  slab *new_slab() {
+    void *raw = ::operator new(slab_bytes_, std::align_val_t(slab_bytes_));
+    slab *s = new (raw) slab;
+    s->bump_ = static_cast<std::byte *>(raw) + first_slot_;
+    link(s, available_, true);
+    ++slabs_;
+    return s;
+  }
+
+  void link(slab *s, slab *&list, bool available) noexcept {
+    s->prev_ = nullptr;
+    s->next_ = list;
+    if (list != nullptr)
+      list->prev_ = s;
+    list = s;
+    s->available_ = available;
+  }
+
+  void unlink(slab *s) noexcept {
+    slab *&list = s->available_ ? available_ : full_;
+    if (s->prev_ != nullptr)
+      s->prev_->next_ = s->next_;
+    else
+      list = s->next_;
+    if (s->next_ != nullptr)
+      s->next_->prev_ = s->prev_;
+  }
+
+  void move_to(slab *s, slab *&list, bool available) noexcept {
+    unlink(s);
+    link(s, list, available);
+  }
+
+  void release_list(slab *s) noexcept {
+    while (s != nullptr)
+      ::operator delete(std::exchange(s, s->next_), std::align_val_t(slab_bytes_));
+  }
+
+  size_t slot_align_;
+  size_t slot_size_;
+  size_t first_slot_; // offset of the first slot, past the header
+  size_t slab_bytes_;
+  slab *available_ = nullptr; // slabs with a free slot, the one to allocate from first
+  slab *full_ = nullptr;      // slabs without one
+  slab *empty_ = nullptr;     // the one emptied slab kept for reuse
+  size_t slabs_ = 0;
+};
+
+/*
+allocator over a slab_pool, e.g. forward_list<int, slab_allocator<int>>
+
+node-based containers rebind it to their node type and allocate one node at a time; those
+single-object requests are served from a pool made on the first of them, anything else
+goes to operator new. copies and rebinds share the pool. a container copy gets a fresh
+allocator (select_on_container_copy_construction), so every container built from a
+default-constructed allocator has a pool of its own and frees its slabs as it empties.
+*/
+template <typename T, size_t SlabBytes = 64 * 1024> class slab_allocator {
+  // shared by every copy and rebind, the pool itself is made on first use
+  using pool_holder = std::unique_ptr<slab_pool>;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U> struct rebind {
+    using other = slab_allocator<U, SlabBytes>;
+  };
+
+  slab_allocator() : state_(std::make_shared<pool_holder>()) {}
+  template <typename U>
+  slab_allocator(const slab_allocator<U, SlabBytes> &oth) noexcept : state_(oth.state_) {}
+
+  T *allocate(size_t n) {
+    if (n == 1) {
+      pool_holder &pool = *state_;
+      if (!pool)
+        pool = std::make_unique<slab_pool>(sizeof(T), alignof(T), SlabBytes);
+      if (serves(*pool))
+        return static_cast<T *>(pool->allocate());
+    }
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *p, size_t n) noexcept {
+    pool_holder &pool = *state_;
+    if (n == 1 && pool && serves(*pool))
+      pool->deallocate(p);
+    else
+      std::allocator<T>().deallocate(p, n);
+  }
+
+  slab_allocator select_on_container_copy_construction() const { return slab_allocator(); }
+
+  /* the pool behind this allocator, null before the first single-object allocation */
+  const slab_pool *pool() const noexcept { return state_->get(); }
+
+  template <typename U>
+  friend bool operator==(const slab_allocator &lhs, const slab_allocator<U, SlabBytes> &rhs) noexcept {
+    return lhs.state_ == rhs.state_;
+  }
+  template <typename U>
+  friend bool operator!=(const slab_allocator &lhs, const slab_allocator<U, SlabBytes> &rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+private:
+  template <typename, size_t> friend class slab_allocator;
+
+  // a pool made for another type serves this one only if the slots fit
+  static bool serves(const slab_pool &pool) noexcept {
+    return sizeof(T) <= pool.slot_size() && alignof(T) <= pool.slot_align();
+  }
+
+  std::shared_ptr<pool_holder> state_;
+};
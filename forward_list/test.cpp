@@ -1,8 +1,18 @@
 #define BOOST_TEST_MODULE
 
 #include "forward_list.cpp"
+#include "lockfree_list.cpp"
+#include "slab_allocator.cpp"
+#include "unrolled_list.cpp"
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(ForwardListTestSuite)
 
 BOOST_AUTO_TEST_CASE(Initialization) {
@@ -292,4 +302,541 @@ BOOST_AUTO_TEST_CASE(ReverseSingleElementList) {
   BOOST_CHECK_EQUAL(list.size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(Clear) {
+  forward_list<int> list;
+  list.clear();
+  BOOST_CHECK(list.empty());
+
+  for (int i = 0; i != 5; ++i)
+    list.push_back(i);
+  list.clear();
+  BOOST_CHECK(list.empty());
+  BOOST_CHECK(list.begin() == list.end());
+
+  // the list is usable again, push_back goes after the sentinel
+  list.push_back(7);
+  list.push_front(6);
+  BOOST_CHECK_EQUAL(list.front(), 6);
+  BOOST_CHECK_EQUAL(list.size(), 2);
+}
+
+template <typename T, typename Alloc> static std::vector<T> elements(const forward_list<T, Alloc> &list) {
+  std::vector<T> out;
+  for (const T &val : list)
+    out.push_back(val);
+  return out;
+}
+
+// push_back goes through tail_, so a wrong tail_ shows up as a lost or misplaced element
+template <typename T, typename Alloc> static bool tail_is_last(forward_list<T, Alloc> &list, const T &val) {
+  size_t n = list.size();
+  list.push_back(val);
+  std::vector<T> all = elements(list);
+  return all.size() == n + 1 && all.back() == val;
+}
+
+BOOST_AUTO_TEST_CASE(SortRelinksStably) {
+  forward_list<std::pair<int, int>> list;
+  std::vector<std::pair<int, int>> model;
+  std::mt19937 rng(3);
+  for (int i = 0; i != 1000; ++i) {
+    std::pair<int, int> val(int(rng() % 50), i);
+    list.push_back(val);
+    model.push_back(val);
+  }
+  auto by_key = [](const std::pair<int, int> &a, const std::pair<int, int> &b) { return a.first < b.first; };
+  list.sort(by_key);
+  std::stable_sort(model.begin(), model.end(), by_key);
+  BOOST_CHECK(elements(list) == model);
+  BOOST_CHECK_EQUAL(list.size(), 1000);
+  BOOST_CHECK(tail_is_last(list, std::pair<int, int>(-1, -1)));
+
+  forward_list<int> small;
+  small.sort();
+  small.reverse();
+  BOOST_CHECK(tail_is_last(small, 2));
+  small.push_back(1);
+  small.sort();
+  BOOST_CHECK(elements(small) == std::vector<int>({1, 2}));
+  small.sort(std::greater<>());
+  BOOST_CHECK(elements(small) == std::vector<int>({2, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(SortKeepsElementsWhenCompareThrows) {
+  forward_list<int> list;
+  for (int i = 0; i != 100; ++i)
+    list.push_back(100 - i);
+
+  int calls = 0;
+  BOOST_CHECK_THROW(list.sort([&](int a, int b) {
+    if (++calls == 150)
+      throw "compare failed";
+    return a < b;
+  }),
+                    const char *);
+  std::vector<int> all = elements(list);
+  std::sort(all.begin(), all.end());
+  BOOST_CHECK_EQUAL(all.size(), 100);
+  BOOST_CHECK_EQUAL(all.front(), 1);
+  BOOST_CHECK_EQUAL(all.back(), 100);
+  BOOST_CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+  BOOST_CHECK(tail_is_last(list, 0));
+}
+
+BOOST_AUTO_TEST_CASE(MergeRelinksNodes) {
+  forward_list<int> a, b;
+  for (int val : {1, 4, 4, 9})
+    a.push_back(val);
+  for (int val : {0, 4, 10, 12})
+    b.push_back(val);
+
+  a.merge(b);
+  BOOST_CHECK(elements(a) == std::vector<int>({0, 1, 4, 4, 4, 9, 10, 12}));
+  BOOST_CHECK_EQUAL(a.size(), 8);
+  BOOST_CHECK(b.empty());
+  BOOST_CHECK(b.begin() == b.end());
+  BOOST_CHECK(tail_is_last(a, 13));
+  BOOST_CHECK(tail_is_last(b, 5));
+
+  // merging into an empty list takes the other's tail
+  forward_list<int> c;
+  c.merge(a);
+  BOOST_CHECK_EQUAL(c.size(), 9);
+  BOOST_CHECK(tail_is_last(c, 14));
+  c.merge(c); // a no-op, the size counts the 14 pushed above
+  BOOST_CHECK_EQUAL(c.size(), 10);
+
+  forward_list<int, slab_allocator<int>> p1, p2;
+  p1.push_back(1);
+  p2.push_back(2);
+  BOOST_CHECK_THROW(p1.merge(p2), const char *);
+  BOOST_CHECK_EQUAL(p2.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(RemoveIfAndUnique) {
+  forward_list<int> list;
+  for (int val : {1, 1, 2, 3, 3, 3, 4, 5, 5})
+    list.push_back(val);
+
+  BOOST_CHECK_EQUAL(list.unique(), 4);
+  BOOST_CHECK(elements(list) == std::vector<int>({1, 2, 3, 4, 5}));
+  BOOST_CHECK(tail_is_last(list, 5));
+  BOOST_CHECK_EQUAL(list.unique(), 1);
+
+  // removing the last element moves tail_ back
+  BOOST_CHECK_EQUAL(list.remove_if([](int val) { return val % 2 == 1; }), 3);
+  BOOST_CHECK(elements(list) == std::vector<int>({2, 4}));
+  BOOST_CHECK_EQUAL(list.size(), 2);
+  BOOST_CHECK(tail_is_last(list, 6));
+
+  BOOST_CHECK_EQUAL(list.remove_if([](int) { return true; }), 3);
+  BOOST_CHECK(list.empty());
+  BOOST_CHECK(tail_is_last(list, 7));
+  BOOST_CHECK_EQUAL(list.front(), 7);
+
+  // unique compares with the last kept element
+  forward_list<int> runs;
+  for (int val : {1, 2, 3, 10, 11, 20})
+    runs.push_back(val);
+  BOOST_CHECK_EQUAL(runs.unique([](int kept, int val) { return val - kept < 5; }), 3);
+  BOOST_CHECK(elements(runs) == std::vector<int>({1, 10, 20}));
+}
+
+BOOST_AUTO_TEST_CASE(SpliceAfterRelinksNodes) {
+  forward_list<int> a, b;
+  for (int val : {1, 2, 3})
+    a.push_back(val);
+  for (int val : {10, 11, 12})
+    b.push_back(val);
+
+  // whole list after the first element, iterators follow their nodes
+  forward_list<int>::iterator eleven = ++b.begin();
+  a.splice_after(a.begin(), b);
+  BOOST_CHECK(elements(a) == std::vector<int>({1, 10, 11, 12, 2, 3}));
+  BOOST_CHECK_EQUAL(a.size(), 6);
+  BOOST_CHECK(b.empty());
+  BOOST_CHECK(tail_is_last(a, 4));
+  BOOST_CHECK(tail_is_last(b, 5));
+  BOOST_CHECK_EQUAL(*eleven, 11);
+
+  // a single node: the one after eleven, then the last one of b, which moves b's tail back
+  b.push_back(6);
+  a.splice_after(a.before_begin(), a, eleven);
+  BOOST_CHECK(elements(a) == std::vector<int>({12, 1, 10, 11, 2, 3, 4}));
+  b.splice_after(b.before_begin(), a, eleven);
+  BOOST_CHECK(elements(b) == std::vector<int>({2, 5, 6}));
+  a.splice_after(eleven, b, ++b.begin());
+  BOOST_CHECK(elements(a) == std::vector<int>({12, 1, 10, 11, 6, 3, 4}));
+  BOOST_CHECK(tail_is_last(b, 7));
+  BOOST_CHECK_EQUAL(a.size() + b.size(), 10);
+  forward_list<int> empty;
+  BOOST_CHECK_THROW(a.splice_after(a.begin(), empty, empty.before_begin()), const char *);
+  a.splice_after(eleven, a, eleven); // a no-op, the element after eleven stays
+  BOOST_CHECK(elements(a) == std::vector<int>({12, 1, 10, 11, 6, 3, 4}));
+
+  // a range ending at the end moves the tail, the empty range (first, first + 1) moves nothing
+  b.splice_after(b.before_begin(), a, eleven, a.end());
+  BOOST_CHECK(elements(a) == std::vector<int>({12, 1, 10, 11}));
+  BOOST_CHECK(elements(b) == std::vector<int>({6, 3, 4, 2, 5, 7}));
+  BOOST_CHECK(tail_is_last(a, 13));
+  b.splice_after(b.begin(), a, a.begin(), ++a.begin());
+  BOOST_CHECK_EQUAL(b.size(), 6);
+
+  // within one list: the last elements move to the front, then the front ones behind four
+  forward_list<int>::iterator four = ++++b.begin();
+  b.splice_after(b.before_begin(), b, four, b.end());
+  BOOST_CHECK(elements(b) == std::vector<int>({2, 5, 7, 6, 3, 4}));
+  BOOST_CHECK(tail_is_last(b, 8));
+  b.splice_after(four, b, b.before_begin(), four);
+  BOOST_CHECK(elements(b) == std::vector<int>({4, 2, 5, 7, 6, 3, 8}));
+  BOOST_CHECK(tail_is_last(b, 9));
+
+  forward_list<int, slab_allocator<int>> p1, p2;
+  p2.push_back(2);
+  BOOST_CHECK_THROW(p1.splice_after(p1.before_begin(), p2), const char *);
+  BOOST_CHECK(p1.empty());
+  BOOST_CHECK_EQUAL(p2.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(SplitAfterAndAppend) {
+  forward_list<int> list;
+  for (int val = 0; val != 10; ++val)
+    list.push_back(val);
+
+  forward_list<int>::iterator four = list.begin();
+  for (int i = 0; i != 4; ++i)
+    ++four;
+  forward_list<int> rest = list.split_after(four);
+  BOOST_CHECK(elements(list) == std::vector<int>({0, 1, 2, 3, 4}));
+  BOOST_CHECK(elements(rest) == std::vector<int>({5, 6, 7, 8, 9}));
+  BOOST_CHECK(tail_is_last(list, 10));
+  BOOST_CHECK(tail_is_last(rest, 11));
+
+  // with the count known, splitting off the front and past the end
+  forward_list<int> all = list.split_after(list.before_begin(), 0);
+  BOOST_CHECK(list.empty());
+  BOOST_CHECK(tail_is_last(list, 12));
+  BOOST_CHECK_EQUAL(all.size(), 6);
+  forward_list<int> ten = all.split_after(four, 5);
+  BOOST_CHECK(elements(ten) == std::vector<int>({10}));
+  BOOST_CHECK(ten.split_after(ten.begin(), 1).empty());
+  BOOST_CHECK(tail_is_last(all, 10));
+  BOOST_CHECK_THROW(all.split_after(four, 7), const char *);
+  ten.splice_after(ten.before_begin(), all, four); // takes the 10 pushed back again
+
+  // appending puts the nodes back in one piece; the list moved from stays usable
+  const int *five = &rest.front();
+  all.append(std::move(rest));
+  BOOST_CHECK(elements(all) == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11}));
+  BOOST_CHECK_EQUAL(&*++four, five);
+  BOOST_CHECK(rest.empty());
+  rest.push_back(1);
+  all.append(std::move(list));
+  all.append(forward_list<int>());
+  BOOST_CHECK_EQUAL(all.size(), 12);
+  BOOST_CHECK(tail_is_last(all, 13));
+
+  // splitting hands the nodes of a slab-backed list over without touching the pool
+  forward_list<int, slab_allocator<int>> pooled;
+  for (int val = 0; val != 100; ++val)
+    pooled.push_back(val);
+  size_t slabs = pooled.get_allocator().pool()->slabs();
+  forward_list<int, slab_allocator<int>> half = pooled.split_after(pooled.before_begin(), 0);
+  half.append(half.split_after(half.begin(), 1));
+  BOOST_CHECK_EQUAL(half.size(), 100);
+  BOOST_CHECK_EQUAL(half.front(), 0);
+  BOOST_CHECK(pooled.empty());
+  BOOST_CHECK_EQUAL(half.get_allocator().pool()->slabs(), slabs);
+}
+
+BOOST_AUTO_TEST_CASE(SlabPoolReusesFreedSlots) {
+  slab_pool pool(24, 8, 4096);
+  BOOST_CHECK_EQUAL(pool.slot_size(), 24);
+  BOOST_CHECK_EQUAL(pool.slabs(), 0);
+
+  void *a = pool.allocate();
+  void *b = pool.allocate();
+  BOOST_CHECK_EQUAL(pool.slabs(), 1);
+  BOOST_CHECK_EQUAL(static_cast<char *>(b) - static_cast<char *>(a), 24);
+
+  // the slot freed last is handed out first
+  pool.deallocate(a);
+  BOOST_CHECK(pool.allocate() == a);
+
+  BOOST_CHECK_THROW(slab_pool(8, 8, 1000), const char *);
+  BOOST_CHECK_THROW(slab_pool(8192, 8, 4096), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(SlabPoolReleasesEmptySlabs) {
+  slab_pool pool(64, 8, 4096);
+  std::vector<void *> slots;
+  while (pool.slabs() < 4)
+    slots.push_back(pool.allocate());
+
+  for (void *p : slots)
+    pool.deallocate(p);
+  // one emptied slab is kept for the next allocation
+  BOOST_CHECK_EQUAL(pool.slabs(), 1);
+  pool.allocate();
+  BOOST_CHECK_EQUAL(pool.slabs(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(SlabAllocatorBacksList) {
+  using list_type = forward_list<std::string, slab_allocator<std::string, 4096>>;
+  list_type list;
+  for (int i = 0; i != 1000; ++i)
+    list.push_back(std::to_string(i));
+
+  const slab_pool *pool = list.get_allocator().pool();
+  BOOST_REQUIRE(pool != nullptr);
+  BOOST_CHECK(pool->slabs() > 1);
+
+  int expected = 0;
+  for (const std::string &val : list)
+    BOOST_CHECK_EQUAL(val, std::to_string(expected++));
+  BOOST_CHECK_EQUAL(expected, 1000);
+
+  // the slabs go with the elements, the sentinel's slab and one spare stay at most
+  list.clear();
+  BOOST_CHECK(pool->slabs() <= 2);
+
+  list.push_front("a");
+  BOOST_CHECK_EQUAL(list.front(), "a");
+}
+
+BOOST_AUTO_TEST_CASE(SlabAllocatorCopiesGetTheirOwnPool) {
+  forward_list<int, slab_allocator<int>> l1;
+  l1.push_back(1);
+  l1.push_back(2);
+
+  forward_list<int, slab_allocator<int>> l2(l1);
+  BOOST_CHECK(l1.get_allocator() != l2.get_allocator());
+  BOOST_CHECK(l1.get_allocator().pool() != l2.get_allocator().pool());
+
+  l2.pop_front();
+  BOOST_CHECK_EQUAL(l1.front(), 1);
+  BOOST_CHECK_EQUAL(l2.front(), 2);
+
+  // swapping and moving take the pool along with the nodes
+  swap(l1, l2);
+  BOOST_CHECK_EQUAL(l1.size(), 1);
+  forward_list<int, slab_allocator<int>> l3(std::move(l2));
+  l3.pop_front();
+  BOOST_CHECK_EQUAL(l3.front(), 2);
+}
+
+template <typename List> static std::vector<typename List::iterator> positions(const List &list) {
+  std::vector<typename List::iterator> its;
+  for (auto it = list.begin(); it != list.end(); ++it)
+    its.push_back(it);
+  return its;
+}
+
+template <typename List> static bool holds(const List &list, const std::vector<std::string> &model) {
+  size_t i = 0;
+  for (const std::string &val : list)
+    if (i == model.size() || val != model[i++])
+      return false;
+  return i == model.size() && list.size() == model.size();
+}
+
+BOOST_AUTO_TEST_CASE(UnrolledPushAndIterate) {
+  unrolled_list<int, 4> list;
+  BOOST_CHECK(list.begin() == list.end());
+  BOOST_CHECK_THROW(list.front(), const char *);
+
+  for (int i = 0; i != 10; ++i)
+    list.push_back(i);
+  list.push_front(-1);
+  BOOST_CHECK_EQUAL(list.front(), -1);
+  BOOST_CHECK_EQUAL(list.size(), 11);
+  // 4 + 4 + 2 from push_back, the push_front found the head full
+  BOOST_CHECK_EQUAL(list.nodes(), 4);
+
+  int expected = -1;
+  for (int val : list)
+    BOOST_CHECK_EQUAL(val, expected++);
+
+  while (!list.empty())
+    list.pop_front();
+  BOOST_CHECK_EQUAL(list.nodes(), 0);
+  BOOST_CHECK_THROW(list.pop_front(), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(UnrolledInsertAfterSplitsFullNode) {
+  unrolled_list<std::string, 4> list;
+  for (int i = 0; i != 4; ++i)
+    list.push_back(std::to_string(i));
+  BOOST_CHECK_EQUAL(list.nodes(), 1);
+
+  auto it = list.insert_after(list.begin(), "x");
+  BOOST_CHECK_EQUAL(*it, "x");
+  BOOST_CHECK_EQUAL(list.nodes(), 2);
+  BOOST_CHECK(holds(list, {"0", "x", "1", "2", "3"}));
+
+  // after the last element of a full node, the new element lands in the upper half
+  it = list.insert_after(positions(list)[2], "y");
+  BOOST_CHECK_EQUAL(*it, "y");
+  BOOST_CHECK(holds(list, {"0", "x", "1", "y", "2", "3"}));
+  list.push_back("z");
+  BOOST_CHECK(holds(list, {"0", "x", "1", "y", "2", "3", "z"}));
+}
+
+BOOST_AUTO_TEST_CASE(UnrolledEraseAfterMergesUnderflowingNodes) {
+  unrolled_list<std::string, 4> list;
+  for (int i = 0; i != 12; ++i)
+    list.push_back(std::to_string(i));
+  BOOST_CHECK_EQUAL(list.nodes(), 3);
+
+  // 0 1 2 3 | 4 5 6 7 | 8 9 10 11: the second node drops below half and borrows from the third
+  auto it = positions(list)[3];
+  list.erase_after(it);
+  list.erase_after(it);
+  list.erase_after(it);
+  BOOST_CHECK_EQUAL(*it, "3");
+  BOOST_CHECK(holds(list, {"0", "1", "2", "3", "7", "8", "9", "10", "11"}));
+  BOOST_CHECK_EQUAL(list.nodes(), 3);
+
+  // erasing the only element of the last node folds it into its predecessor
+  unrolled_list<std::string, 4> tail;
+  for (int i = 0; i != 5; ++i)
+    tail.push_back(std::to_string(i));
+  tail.erase_after(positions(tail)[1]);
+  tail.erase_after(positions(tail)[2]);
+  BOOST_CHECK(holds(tail, {"0", "1", "3"}));
+  BOOST_CHECK_EQUAL(tail.nodes(), 1);
+  BOOST_CHECK_THROW(tail.erase_after(positions(tail)[2]), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(UnrolledMatchesModelUnderRandomEdits) {
+  std::mt19937 rng(7);
+  unrolled_list<std::string, 5> list;
+  std::vector<std::string> model;
+
+  for (int step = 0; step != 4000; ++step) {
+    std::string val = std::to_string(step);
+    unsigned op = rng() % 6;
+    if (op == 0) {
+      list.push_back(val);
+      model.push_back(val);
+    } else if (op == 1) {
+      list.push_front(val);
+      model.insert(model.begin(), val);
+    } else if (op == 2 && !model.empty()) {
+      list.pop_front();
+      model.erase(model.begin());
+    } else if (op == 3 && !model.empty()) {
+      size_t i = rng() % model.size();
+      BOOST_CHECK_EQUAL(*list.insert_after(positions(list)[i], val), val);
+      model.insert(model.begin() + i + 1, val);
+    } else if (model.size() > 1) {
+      size_t i = rng() % (model.size() - 1);
+      list.erase_after(positions(list)[i]);
+      model.erase(model.begin() + i + 1);
+    }
+    if (step % 97 == 0)
+      BOOST_REQUIRE(holds(list, model));
+  }
+  BOOST_CHECK(holds(list, model));
+  // all nodes but the two at the ends stay at least half full
+  BOOST_CHECK(list.nodes() <= 2 + list.size() / 2);
+
+  unrolled_list<std::string, 5> copy(list);
+  BOOST_CHECK(copy == list);
+  copy.push_back("extra");
+  BOOST_CHECK(copy != list);
+  swap(copy, list);
+  BOOST_CHECK_EQUAL(list.size(), model.size() + 1);
+  list = std::move(copy);
+  BOOST_CHECK(holds(list, model));
+}
+
+template <typename List> static std::vector<int> contents(const List &list) {
+  std::vector<int> out;
+  list.for_each([&](int val) { out.push_back(val); });
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(LockFreeListKeepsSortedSet) {
+  lockfree_list<int> list;
+  BOOST_CHECK(list.empty());
+  BOOST_CHECK(!list.contains(3));
+  BOOST_CHECK(!list.remove(3));
+
+  for (int val : {5, 1, 9, 3, 7})
+    BOOST_CHECK(list.insert(val));
+  BOOST_CHECK(!list.insert(5));
+  BOOST_CHECK_EQUAL(list.size(), 5);
+  BOOST_CHECK(contents(list) == std::vector<int>({1, 3, 5, 7, 9}));
+
+  BOOST_CHECK(list.remove(1));
+  BOOST_CHECK(list.remove(9));
+  BOOST_CHECK(!list.remove(9));
+  BOOST_CHECK(list.contains(5));
+  BOOST_CHECK(!list.contains(1));
+  BOOST_CHECK(contents(list) == std::vector<int>({3, 5, 7}));
+
+  lockfree_list<int, std::greater<int>> descending;
+  for (int val : {2, 8, 4})
+    descending.insert(val);
+  BOOST_CHECK(contents(descending) == std::vector<int>({8, 4, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(LockFreeListConcurrentDisjointInserts) {
+  constexpr int threads = 4, per_thread = 500;
+  lockfree_list<int> list;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t != threads; ++t)
+    workers.emplace_back([&list, t] {
+      for (int i = 0; i != per_thread; ++i)
+        list.insert(i * threads + t);
+    });
+  for (std::thread &w : workers)
+    w.join();
+
+  std::vector<int> expected(threads * per_thread);
+  for (int i = 0; i != threads * per_thread; ++i)
+    expected[i] = i;
+  BOOST_CHECK(contents(list) == expected);
+  BOOST_CHECK_EQUAL(list.size(), expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(LockFreeListConcurrentMixedOperations) {
+  constexpr int threads = 4, steps = 4000, keys = 64;
+  lockfree_list<int> list;
+  std::atomic<long> balance{0}; // successful inserts minus successful removes
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t != threads; ++t)
+    workers.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      long local = 0;
+      for (int i = 0; i != steps; ++i) {
+        int key = int(rng() % keys);
+        switch (rng() % 3) {
+        case 0:
+          local += list.insert(key);
+          break;
+        case 1:
+          local -= list.remove(key);
+          break;
+        default:
+          list.contains(key);
+        }
+      }
+      balance += local;
+    });
+  for (std::thread &w : workers)
+    w.join();
+
+  std::vector<int> left = contents(list);
+  BOOST_CHECK(std::is_sorted(left.begin(), left.end()));
+  BOOST_CHECK(std::adjacent_find(left.begin(), left.end()) == left.end());
+  BOOST_CHECK_EQUAL(long(left.size()), balance.load());
+  BOOST_CHECK_EQUAL(list.size(), left.size());
+  // removed nodes are freed as threads go, only a bounded backlog waits for reclamation
+  BOOST_CHECK(lockfree_list<int>::pending_reclamation() < size_t(threads * steps));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
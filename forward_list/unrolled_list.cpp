@@ -0,0 +1,341 @@
+#pragma once
+
+#include "./../memory_accounting/memory_accounting.cpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/*
+singly linked list holding up to K elements per node
+
+a forward_list node holds one element, so walking the list takes a cache miss per element.
+here a node holds a small array of up to K contiguous elements and a walk misses once per
+node. K defaults to what fills a 256-byte node (four cache lines), at least 4; e.g.
+unrolled_list<T, (4096 - 16) / sizeof(T)> makes nodes about a page big.
+
+push_back() and push_front() are O(1): they fill the tail or head node and start a new
+node once it is full (push_front shifts at most K elements within the head node).
+insert_after() into a full node splits it in two halves. an erase that leaves a node less
+than half full merges it with its successor, or borrows from it when both do not fit in
+one node, so nodes stay at least half full apart from the ones at either end.
+
+insert_after() and erase_after() invalidate iterators into the nodes they shift, split or
+merge; erase_after() keeps the iterator passed in valid. moving elements is assumed not to
+throw.
+*/
+template <typename T, size_t K = (sizeof(T) * 4 > 240 ? 4 : 240 / sizeof(T))> class unrolled_list {
+  static_assert(K >= 2, "a node needs room for at least two elements to split");
+
+  struct Node {
+    Node *next_ = nullptr;
+    size_t count_ = 0;
+    alignas(T) std::byte storage_[K * sizeof(T)];
+
+    T *items() noexcept { return std::launder(reinterpret_cast<T *>(storage_)); }
+    const T *items() const noexcept { return std::launder(reinterpret_cast<const T *>(storage_)); }
+    bool full() const noexcept { return count_ == K; }
+
+    /* constructs the element at position i, shifting [i, count_) one to the right */
+    template <typename Arg> void insert(size_t i, Arg &&val) {
+      T *items = this->items();
+      if (i == count_) {
+        new (items + i) T(std::forward<Arg>(val));
+      } else {
+        T tmp(std::forward<Arg>(val)); // the only step that may throw
+        new (items + count_) T(std::move(items[count_ - 1]));
+        std::move_backward(items + i, items + count_ - 1, items + count_);
+        items[i] = std::move(tmp);
+      }
+      ++count_;
+    }
+
+    /* destroys the element at position i, shifting (i, count_) one to the left */
+    void erase(size_t i) noexcept {
+      T *items = this->items();
+      std::move(items + i + 1, items + count_, items + i);
+      items[--count_].~T();
+    }
+
+    /* moves the elements [from, from + n) to the end of dst */
+    void move_to(Node &dst, size_t from, size_t n) noexcept {
+      T *src = items() + from;
+      T *out = dst.items() + dst.count_;
+      for (size_t k = 0; k != n; ++k) {
+        new (out + k) T(std::move(src[k]));
+        src[k].~T();
+      }
+      dst.count_ += n;
+      // close the gap the moved elements left behind
+      T *items = this->items();
+      for (size_t k = from + n; k != count_; ++k) {
+        new (items + k - n) T(std::move(items[k]));
+        items[k].~T();
+      }
+      count_ -= n;
+    }
+  };
+
+public:
+  static constexpr size_t node_capacity = K;
+
+  class iterator {
+  public:
+    iterator(Node *node = nullptr, size_t index = 0) : node_(node), index_(index) {}
+
+    T &operator*() { return node_->items()[index_]; }
+    T *operator->() { return node_->items() + index_; }
+
+    iterator &operator++() {
+      if (++index_ == node_->count_) {
+        node_ = node_->next_;
+        index_ = 0;
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const iterator &lhs, const iterator &rhs) {
+      return lhs.node_ == rhs.node_ && lhs.index_ == rhs.index_;
+    }
+
+    friend bool operator!=(const iterator &lhs, const iterator &rhs) { return !(lhs == rhs); }
+
+    friend class unrolled_list;
+
+  private:
+    Node *node_;
+    size_t index_;
+  };
+
+  iterator begin() const { return iterator(head_, 0); }
+  iterator end() const { return iterator(nullptr, 0); }
+
+  unrolled_list() : head_(nullptr), tail_(nullptr), size_(0) {}
+
+  explicit unrolled_list(memory_tag tag) : tag_(tag), head_(nullptr), tail_(nullptr), size_(0) {}
+
+  // copy constructor, the destructor cleans up if a copy throws (the delegated constructor has run)
+  unrolled_list(const unrolled_list &oth) : unrolled_list(oth.tag_) {
+    for (const Node *node = oth.head_; node != nullptr; node = node->next_)
+      for (size_t i = 0; i != node->count_; ++i)
+        push_back(node->items()[i]);
+  }
+
+  // copy assignment
+  unrolled_list &operator=(const unrolled_list &oth) {
+    // copy-and-swap idiom
+    unrolled_list tmp(oth); // copy
+    swap(*this, tmp);       // swap
+    return *this;
+  }
+
+  // move constructor
+  unrolled_list(unrolled_list &&oth) noexcept : unrolled_list(oth.tag_) { swap(*this, oth); }
+
+  // move assignment
+  unrolled_list &operator=(unrolled_list &&oth) noexcept {
+    // move-and-swap idiom
+    unrolled_list tmp(std::move(oth)); // move
+    swap(*this, tmp);                  // swap
+    return *this;
+  }
+
+  ~unrolled_list() { clear(); }
+
+  friend void swap(unrolled_list &lhs, unrolled_list &rhs) noexcept {
+    using std::swap;
+    swap(lhs.head_, rhs.head_);
+    swap(lhs.tail_, rhs.tail_);
+    swap(lhs.size_, rhs.size_);
+    swap(lhs.tag_, rhs.tag_);
+  }
+
+  T &front() {
+    if (empty())
+      throw "empty list";
+    return head_->items()[0];
+  }
+
+  const T &front() const {
+    if (empty())
+      throw "empty list";
+    return head_->items()[0];
+  }
+
+  void push_back(const T &val) {
+    if (tail_ == nullptr || tail_->full()) {
+      Node *node = make_node(val);
+      if (tail_ == nullptr)
+        head_ = node;
+      else
+        tail_->next_ = node;
+      tail_ = node;
+    } else {
+      tail_->insert(tail_->count_, val);
+    }
+    ++size_;
+  }
+
+  void push_front(const T &val) {
+    if (head_ == nullptr || head_->full()) {
+      Node *node = make_node(val);
+      node->next_ = head_;
+      head_ = node;
+      if (tail_ == nullptr)
+        tail_ = node;
+    } else {
+      head_->insert(0, val);
+    }
+    ++size_;
+  }
+
+  void pop_front() {
+    if (empty())
+      throw "empty list";
+
+    head_->erase(0);
+    --size_;
+    if (head_->count_ == 0) {
+      destroy_node(std::exchange(head_, head_->next_));
+      if (head_ == nullptr)
+        tail_ = nullptr;
+    } else {
+      rebalance(head_);
+    }
+  }
+
+  /* inserts val right after *iter, returns an iterator to it */
+  iterator insert_after(const iterator iter, const T &val) {
+    Node *node = iter.node_;
+    size_t i = iter.index_ + 1;
+    if (node->full()) {
+      // split: the upper half moves to a new node right after this one
+      Node *upper = new Node;
+      tag_.on_allocate(sizeof(Node));
+      size_t half = K / 2;
+      node->move_to(*upper, half, K - half);
+      upper->next_ = node->next_;
+      node->next_ = upper;
+      if (tail_ == node)
+        tail_ = upper;
+
+      if (i > half) {
+        node = upper;
+        i -= half;
+      }
+    }
+    node->insert(i, val);
+    ++size_;
+    return iterator(node, i);
+  }
+
+  /* erases the element right after *iter, iter itself stays valid */
+  void erase_after(const iterator iter) {
+    Node *prev = nullptr;
+    Node *node = iter.node_;
+    size_t i = iter.index_ + 1;
+    if (i == node->count_) {
+      prev = node;
+      node = node->next_;
+      i = 0;
+    }
+    if (node == nullptr)
+      throw "no element after iterator";
+
+    node->erase(i);
+    --size_;
+
+    if (node->next_ != nullptr) {
+      rebalance(node);
+    } else if (prev != nullptr && prev->count_ + node->count_ <= K) {
+      // the last node underflowed, fold it into its predecessor
+      node->move_to(*prev, 0, node->count_);
+      prev->next_ = nullptr;
+      tail_ = prev;
+      destroy_node(node);
+    }
+  }
+
+  /* destroys every element and frees every node */
+  void clear() noexcept {
+    for (Node *node = head_; node != nullptr;) {
+      for (size_t i = 0; i != node->count_; ++i)
+        node->items()[i].~T();
+      destroy_node(std::exchange(node, node->next_));
+    }
+    head_ = tail_ = nullptr;
+    size_ = 0;
+  }
+
+  friend bool operator==(const unrolled_list &lhs, const unrolled_list &rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    for (iterator l = lhs.begin(), r = rhs.begin(); l != lhs.end(); ++l, ++r)
+      if (!(*l == *r))
+        return false;
+    return true;
+  }
+
+  friend bool operator!=(const unrolled_list &lhs, const unrolled_list &rhs) {
+    return !(lhs == rhs);
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return 0 == size_; }
+
+  /* number of nodes, size() / nodes() is the average fill */
+  size_t nodes() const noexcept {
+    size_t n = 0;
+    for (const Node *node = head_; node != nullptr; node = node->next_)
+      ++n;
+    return n;
+  }
+
+private:
+  /* a new unlinked node holding just val */
+  Node *make_node(const T &val) {
+    Node *node = new Node;
+    try {
+      node->insert(0, val);
+    } catch (...) {
+      delete node;
+      throw;
+    }
+    tag_.on_allocate(sizeof(Node));
+    return node;
+  }
+
+  void destroy_node(Node *node) noexcept {
+    tag_.on_deallocate(sizeof(Node));
+    delete node;
+  }
+
+  /* tops node up from its successor once it is less than half full */
+  void rebalance(Node *node) noexcept {
+    Node *next = node->next_;
+    if (node->count_ >= K / 2 || next == nullptr)
+      return;
+
+    if (node->count_ + next->count_ <= K) {
+      next->move_to(*node, 0, next->count_);
+      node->next_ = next->next_;
+      if (tail_ == next)
+        tail_ = node;
+      destroy_node(next);
+    } else {
+      next->move_to(*node, 0, K / 2 - node->count_);
+    }
+  }
+
+  [[no_unique_address]] memory_tag tag_;
+  Node *head_; // first node, null when empty
+  Node *tail_; // last node, null when empty
+  size_t size_;
+};
@@ -0,0 +1,72 @@
+#include "./../benchmark.cpp"
+#include "./../vector/vector.cpp"
+#include "linear_allocator.cpp"
+
+#include <cstdlib>
+#include <vector>
+
+/*
+per-frame scratch memory: every frame fills `lists` temporary vectors of a few dozen ints
+and drops them at the end of the frame, with std::allocator (one malloc/free pair per
+vector) and with a linear_arena rewound by a frame scope
+usage: ./bench [frames] [lists per frame]
+*/
+
+template <typename Make> static void frame_work(const std::vector<uint32_t> &sizes, Make make) {
+  size_t sum = 0;
+  for (uint32_t n : sizes) {
+    auto v = make(n);
+    for (uint32_t i = 0; i != n; ++i)
+      v[i] = int(i);
+    sum += v[n / 2];
+  }
+  do_not_optimize(sum);
+}
+
+int main(int argc, char **argv) {
+  size_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+  size_t lists = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+
+  std::vector<uint32_t> sizes(lists);
+  for (uint32_t &n : sizes)
+    n = uint32_t(bench_rng()() % 60 + 4);
+
+  double heap = best_of(3, [&] {
+    for (size_t f = 0; f != frames; ++f)
+      frame_work(sizes, [](size_t n) { return vector<int>(n); });
+  });
+
+  linear_arena arena;
+  double linear = best_of(3, [&] {
+    for (size_t f = 0; f != frames; ++f) {
+      linear_arena::frame frame(arena);
+      frame_work(sizes, [&](size_t n) {
+        return vector<int, linear_allocator<int>>(n, 0, linear_allocator<int>(arena));
+      });
+    }
+  });
+
+  // the raw cost of one allocation and its release
+  const size_t n = frames * lists;
+  double raw_heap = best_of(3, [&] {
+    for (size_t i = 0; i != n; ++i) {
+      void *p = ::operator new(sizes[i % lists] * 4);
+      do_not_optimize(p);
+      ::operator delete(p);
+    }
+  });
+  double raw_linear = best_of(3, [&] {
+    for (size_t i = 0; i != n; i += lists) {
+      linear_arena::frame frame(arena);
+      for (size_t j = 0; j != lists; ++j)
+        do_not_optimize(arena.allocate(sizes[j] * 4, alignof(int)));
+    }
+  });
+
+  std::printf("%zu frames of %zu scratch vectors (ns per vector), arena holds %zu blocks\n", frames,
+              lists, arena.blocks());
+  std::printf("%-24s %12s %12s\n", "", "heap", "linear");
+  std::printf("%-24s %12.2f %12.2f\n", "fill and drop vector", heap / n * 1e9, linear / n * 1e9);
+  std::printf("%-24s %12.2f %12.2f\n", "allocate and release", raw_heap / n * 1e9,
+              raw_linear / n * 1e9);
+}
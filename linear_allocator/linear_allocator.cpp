@@ -0,0 +1,173 @@
+#pragma once
+
+#include "./../stack/stack.cpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+/*
+bump allocator over stack_base blocks
+
+a stack_base<std::byte> is already a bump region: start_ is the block, end_ the next free
+byte and capacity_ its end. allocate() aligns end_ up and bumps it, O(1) and branch-light.
+a request that does not fit moves on to an overflow block (a spare one left over from an
+earlier rewind if it is large enough, a new one of max(block_size, request) otherwise), so
+the arena never fails short of the system running out of memory.
+
+memory is released in LIFO order only: mark() saves the current position, rewind()
+returns to it and releases everything allocated since in one step, frame does both as an
+RAII scope. deallocate() of the most recent allocation moves end_ back, any other
+deallocate() is a no-op until the next rewind. blocks are kept across rewinds, so a
+per-frame arena reaches a steady state where allocating costs a bump and freeing nothing.
+
+a growing container allocates its new buffer before it frees the old one, so the old
+buffer is never the most recent allocation and stays used until the next rewind: a vector
+grown by push_back from empty holds every buffer it ever had. containers on an arena
+should reserve() what they need up front.
+*/
+class linear_arena {
+  using block = stack_base<std::byte>;
+
+public:
+  /* a position in the arena, valid until the arena is rewound past it */
+  struct marker {
+    size_t block_;   // number of full blocks below the current one
+    std::byte *top_; // end_ of the current block
+  };
+
+  /* rewinds the arena to where it was when the frame was made */
+  class frame {
+  public:
+    explicit frame(linear_arena &arena) : arena_(arena), mark_(arena.mark()) {}
+    frame(const frame &) = delete;
+    frame &operator=(const frame &) = delete;
+    ~frame() { arena_.rewind(mark_); }
+
+  private:
+    linear_arena &arena_;
+    marker mark_;
+  };
+
+  explicit linear_arena(size_t block_size = 64 * 1024, memory_tag tag = memory_tag())
+      : block_size_(block_size ? block_size : 1), current_(block_size_, tag), tag_(tag) {}
+
+  linear_arena(const linear_arena &) = delete;
+  linear_arena &operator=(const linear_arena &) = delete;
+
+  /* align must be a power of two */
+  void *allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    std::byte *p = align_up(current_.end_, align);
+    if (bytes > size_t(current_.capacity_ - p))
+      return allocate_overflow(bytes, align);
+    current_.end_ = p + bytes;
+    return p;
+  }
+
+  /* only the most recent allocation is given back, never the old buffer of a growing container */
+  void deallocate(void *p, size_t bytes) noexcept {
+    if (static_cast<std::byte *>(p) + bytes == current_.end_)
+      current_.end_ = static_cast<std::byte *>(p);
+  }
+
+  marker mark() const noexcept { return marker{full_.size(), current_.end_}; }
+
+  void rewind(marker m) noexcept {
+    pop_blocks(m.block_);
+    current_.end_ = m.top_;
+  }
+
+  /* releases every allocation, keeps the blocks */
+  void reset() noexcept {
+    pop_blocks(0);
+    current_.end_ = current_.start_;
+  }
+
+  /* bytes allocated since the last reset, alignment padding included */
+  size_t used() const noexcept { return full_used_ + current_.size(); }
+
+  size_t blocks() const noexcept { return 1 + full_.size() + spare_.size(); }
+
+private:
+  static std::byte *align_up(std::byte *p, size_t align) noexcept {
+    return reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(p) + align - 1) &
+                                         ~uintptr_t(align - 1));
+  }
+
+  void *allocate_overflow(size_t bytes, size_t align) {
+    // room to park every block as a spare, so that rewinding never allocates, and room for
+    // current_ in full_, so that nothing below can throw once a block is taken
+    spare_.reserve(blocks() + 1);
+    full_.reserve(full_.size() + 1);
+
+    size_t needed = bytes + align - 1;
+    block next = spare_.empty() || spare_.top().capacity() < needed
+                     ? block(needed > block_size_ ? needed : block_size_, tag_)
+                     : spare_.pop_value();
+
+    full_.push(std::move(current_));
+    full_used_ += full_.top().size();
+    current_ = std::move(next);
+
+    std::byte *p = align_up(current_.end_, align);
+    current_.end_ = p + bytes;
+    return p;
+  }
+
+  /* makes the n-th full block current again, the blocks above it become spares */
+  void pop_blocks(size_t n) noexcept {
+    while (full_.size() > n) {
+      current_.end_ = current_.start_;
+      spare_.push(std::move(current_));
+      current_ = full_.pop_value();
+      full_used_ -= current_.size();
+    }
+  }
+
+  size_t block_size_;
+  block current_;        // block allocations are bumped from
+  stack<block> full_;    // blocks below current_, oldest at the bottom
+  stack<block> spare_;   // emptied blocks kept for reuse
+  size_t full_used_ = 0; // bytes allocated in the blocks of full_
+
+  [[no_unique_address]] memory_tag tag_;
+};
+
+/*
+std allocator interface over a linear_arena, e.g. vector<int, linear_allocator<int>>
+
+copies share the arena, which must outlive every container using it. containers built
+on it free nothing individually: their memory comes back when the arena is rewound
+*/
+template <typename T> class linear_allocator {
+public:
+  using value_type = T;
+  // the memory belongs to the arena, so the arena travels with it
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  linear_allocator(linear_arena &arena) noexcept : arena_(&arena) {}
+  template <typename U>
+  linear_allocator(const linear_allocator<U> &oth) noexcept : arena_(oth.arena_) {}
+
+  T *allocate(size_t n) { return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T *p, size_t n) noexcept { arena_->deallocate(p, n * sizeof(T)); }
+
+  linear_arena &arena() const noexcept { return *arena_; }
+
+  template <typename U>
+  friend bool operator==(const linear_allocator &lhs, const linear_allocator<U> &rhs) noexcept {
+    return &lhs.arena() == &rhs.arena();
+  }
+  template <typename U>
+  friend bool operator!=(const linear_allocator &lhs, const linear_allocator<U> &rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+private:
+  template <typename> friend class linear_allocator;
+
+  linear_arena *arena_;
+};
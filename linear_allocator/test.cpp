@@ -0,0 +1,132 @@
+#define BOOST_TEST_MODULE LinearAllocatorTests
+#include <boost/test/included/unit_test.hpp>
+
+#include "./../vector/vector.cpp"
+#include "linear_allocator.cpp"
+
+#include <cstdint>
+#include <string>
+
+static bool aligned(void *p, size_t align) { return reinterpret_cast<uintptr_t>(p) % align == 0; }
+
+BOOST_AUTO_TEST_SUITE(LinearAllocatorTestSuite)
+
+BOOST_AUTO_TEST_CASE(BumpsAlignedAllocations) {
+  linear_arena arena(1024);
+  char *a = static_cast<char *>(arena.allocate(3, 1));
+  char *b = static_cast<char *>(arena.allocate(5, 1));
+  BOOST_CHECK(b == a + 3);
+
+  void *c = arena.allocate(8, 64);
+  BOOST_CHECK(aligned(c, 64));
+  void *d = arena.allocate(1);
+  BOOST_CHECK(aligned(d, alignof(std::max_align_t)));
+  BOOST_CHECK_EQUAL(arena.blocks(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ChainsOverflowBlocks) {
+  linear_arena arena(256);
+  arena.allocate(200, 1);
+  char *p = static_cast<char *>(arena.allocate(100, 1)); // does not fit the first block
+  BOOST_CHECK_EQUAL(arena.blocks(), 2);
+  BOOST_CHECK_EQUAL(arena.used(), 300);
+
+  void *big = arena.allocate(1000, 32); // larger than a block gets a block of its own
+  BOOST_CHECK(aligned(big, 32));
+  BOOST_CHECK_EQUAL(arena.blocks(), 3);
+  std::fill(p, p + 100, 'x'); // every allocation is usable memory
+  std::fill(static_cast<char *>(big), static_cast<char *>(big) + 1000, 'y');
+}
+
+BOOST_AUTO_TEST_CASE(RewindsToMarker) {
+  linear_arena arena(256);
+  void *first = arena.allocate(16);
+  linear_arena::marker m = arena.mark();
+  void *second = arena.allocate(16);
+  arena.allocate(300); // spills into a second block
+  BOOST_CHECK_EQUAL(arena.blocks(), 2);
+
+  arena.rewind(m);
+  BOOST_CHECK_EQUAL(arena.used(), 16);
+  BOOST_CHECK_EQUAL(arena.allocate(16), second);
+  BOOST_CHECK(first != second);
+
+  // the second block was kept and is reused instead of allocating a third
+  arena.allocate(300);
+  BOOST_CHECK_EQUAL(arena.blocks(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(FrameReleasesOnScopeExit) {
+  linear_arena arena(1024);
+  arena.allocate(10, 1);
+  for (int i = 0; i != 3; ++i) {
+    linear_arena::frame frame(arena);
+    arena.allocate(500, 1);
+    arena.allocate(600, 1);
+    BOOST_CHECK_EQUAL(arena.used(), 1110);
+  }
+  BOOST_CHECK_EQUAL(arena.used(), 10);
+  BOOST_CHECK_EQUAL(arena.blocks(), 2); // steady state, no block per frame
+
+  arena.reset();
+  BOOST_CHECK_EQUAL(arena.used(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(DeallocateGivesBackOnlyTheTop) {
+  linear_arena arena(1024);
+  void *a = arena.allocate(32);
+  void *b = arena.allocate(32);
+  arena.deallocate(a, 32); // not the top, kept until the next rewind
+  BOOST_CHECK_EQUAL(arena.used(), 64);
+  arena.deallocate(b, 32);
+  BOOST_CHECK_EQUAL(arena.used(), 32);
+  BOOST_CHECK_EQUAL(arena.allocate(32), b);
+}
+
+BOOST_AUTO_TEST_CASE(BacksVector) {
+  linear_arena arena(4096);
+  {
+    linear_arena::frame frame(arena);
+    vector<std::string, linear_allocator<std::string>> names(arena);
+    names.reserve(4);
+    for (int i = 0; i != 100; ++i)
+      names.push_back(std::to_string(i));
+    BOOST_CHECK_EQUAL(names.size(), 100);
+    BOOST_CHECK_EQUAL(names[42], "42");
+
+    vector<std::string, linear_allocator<std::string>> copy(names);
+    BOOST_CHECK_EQUAL(copy[99], "99");
+  }
+  BOOST_CHECK_EQUAL(arena.used(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(GrowthKeepsOldBuffersUntilRewind) {
+  linear_arena arena(64 * 1024);
+  {
+    // every buffer push_back outgrew is still counted, it was freed below the top
+    linear_arena::frame frame(arena);
+    vector<int, linear_allocator<int>> grown(arena);
+    for (int i = 0; i != 100; ++i)
+      grown.push_back(i);
+    BOOST_CHECK(arena.used() > grown.capacity() * sizeof(int));
+  }
+  BOOST_CHECK_EQUAL(arena.used(), 0);
+
+  vector<int, linear_allocator<int>> reserved(arena);
+  reserved.reserve(100);
+  for (int i = 0; i != 100; ++i)
+    reserved.push_back(i);
+  BOOST_CHECK_EQUAL(arena.used(), 100 * sizeof(int));
+}
+
+BOOST_AUTO_TEST_CASE(AllocatorsCompareByArena) {
+  linear_arena a, b;
+  linear_allocator<int> x(a), y(a), z(b);
+  linear_allocator<double> w(x);
+  BOOST_CHECK(x == y);
+  BOOST_CHECK(x != z);
+  BOOST_CHECK(w == x);
+  BOOST_CHECK_EQUAL(&w.arena(), &a);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,47 @@
+#include "./../benchmark.cpp"
+#include "./../forward_list/forward_list.cpp"
+#include "./../stack/stack.cpp"
+#include "./../vector/vector.cpp"
+#include "memory_accounting.cpp"
+
+#include <cstdlib>
+
+/*
+cost of the accounting hooks on allocation-heavy loops; build it twice and compare
+  g++ -std=c++20 -O2 bench.cpp -o bench_off
+  g++ -std=c++20 -O2 -DCONTAINERS_MEMORY_ACCOUNTING bench.cpp -o bench_on
+usage: ./bench [iterations]
+*/
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+  memory_tag tag("bench");
+
+  double small_vectors = best_of(3, [&] {
+    for (size_t i = 0; i != n; ++i) {
+      vector<int> v(4, int(i), std::allocator<int>(), tag);
+      do_not_optimize(v[0]);
+    }
+  });
+
+  double list_churn = best_of(3, [&] {
+    forward_list<int> list(tag);
+    for (size_t i = 0; i != n; ++i)
+      list.push_back(int(i));
+    for (size_t i = 0; i != n; ++i)
+      list.pop_front();
+  });
+
+  double stacks = best_of(3, [&] {
+    for (size_t i = 0; i != n; ++i) {
+      stack<int> s(8, tag);
+      s.push(int(i));
+      do_not_optimize(s.top());
+    }
+  });
+
+  std::printf("accounting %s, sizeof(vector<int>) %zu, sizeof(stack<int>) %zu (ns per op)\n",
+              memory_tag::enabled ? "on" : "off", sizeof(vector<int>), sizeof(stack<int>));
+  std::printf("%-24s %10.2f\n", "vector alloc+free", small_vectors / n * 1e9);
+  std::printf("%-24s %10.2f\n", "forward_list push+pop", list_churn / n * 1e9);
+  std::printf("%-24s %10.2f\n", "stack alloc+free", stacks / n * 1e9);
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifdef CONTAINERS_MEMORY_ACCOUNTING
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#endif
+
+/*
+opt-in accounting of container memory by tag
+
+a container constructed with memory_tag("name") reports every allocation, deallocation
+and reallocation of its storage to that tag; containers built without one report to
+"untagged". memory_snapshot() returns live bytes, peak bytes, allocation count and
+reallocation count per tag.
+
+the hooks are compiled in only when CONTAINERS_MEMORY_ACCOUNTING is defined. otherwise
+memory_tag is an empty class whose hooks are empty inline functions, containers hold it as
+a [[no_unique_address]] member and the whole layer compiles down to nothing.
+*/
+
+struct memory_stats {
+  const char *tag;
+  int64_t live_bytes;
+  int64_t peak_bytes;
+  uint64_t allocations;
+  uint64_t reallocations;
+};
+
+#ifdef CONTAINERS_MEMORY_ACCOUNTING
+
+namespace memory_accounting {
+
+inline constexpr size_t max_tags = 64;
+
+// a thread publishes its byte delta for a tag once it grows past this, so the shared
+// counters are touched once per ~64 KiB of churn instead of on every allocation
+inline constexpr int64_t flush_bytes = 64 * 1024;
+
+struct alignas(64) tag_totals {
+  std::atomic<const char *> name_{nullptr};
+  std::atomic<int64_t> live_{0};
+  std::atomic<int64_t> peak_{0};
+  std::atomic<uint64_t> allocations_{0};   // of threads that have exited
+  std::atomic<uint64_t> reallocations_{0}; // of threads that have exited
+};
+
+/* per-thread counters, written only by their own thread and read by snapshots */
+struct thread_counters {
+  thread_counters();
+  ~thread_counters();
+
+  std::atomic<int64_t> pending_[max_tags] = {}; // bytes not yet added to tag_totals::live_
+  std::atomic<uint64_t> allocations_[max_tags] = {};
+  std::atomic<uint64_t> reallocations_[max_tags] = {};
+};
+
+class registry {
+public:
+  static registry &instance() {
+    static registry r;
+    return r;
+  }
+
+  /* id of the tag called name, registering it on first use */
+  uint32_t tag_id(const char *name) {
+    std::lock_guard<std::mutex> lk(m_);
+    for (size_t id = 0; id != count_; ++id)
+      if (std::strcmp(tags_[id].name_.load(), name) == 0)
+        return uint32_t(id);
+
+    if (count_ == max_tags)
+      throw "too many memory tags";
+    tags_[count_].name_ = name;
+    return uint32_t(count_++);
+  }
+
+  const char *name(uint32_t id) const { return tags_[id].name_.load(); }
+
+  void flush(uint32_t id, int64_t bytes) {
+    raise_peak(id, tags_[id].live_.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+  }
+
+  /* flushed bytes plus the caller's pending ones, both are read-mostly cache lines */
+  void raise_peak(uint32_t id, int64_t live) {
+    int64_t peak = tags_[id].peak_.load(std::memory_order_relaxed);
+    while (live > peak && !tags_[id].peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+      ;
+  }
+
+  int64_t flushed_live(uint32_t id) const { return tags_[id].live_.load(std::memory_order_relaxed); }
+
+  void add(thread_counters *counters) {
+    std::lock_guard<std::mutex> lk(m_);
+    threads_.push_back(counters);
+  }
+
+  /* folds the counters of an exiting thread into the totals */
+  void remove(thread_counters *counters) {
+    std::lock_guard<std::mutex> lk(m_);
+    for (size_t id = 0; id != count_; ++id) {
+      flush(uint32_t(id), counters->pending_[id].load(std::memory_order_relaxed));
+      tags_[id].allocations_ += counters->allocations_[id].load(std::memory_order_relaxed);
+      tags_[id].reallocations_ += counters->reallocations_[id].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i != threads_.size(); ++i)
+      if (threads_[i] == counters) {
+        threads_[i] = threads_.back();
+        threads_.pop_back();
+        break;
+      }
+  }
+
+  /*
+  live bytes are exact up to the deltas other threads change while the snapshot runs. the
+  peak is tracked from each thread's own view (flushed bytes plus its pending ones), exact
+  for a tag used by one thread and low by at most flush_bytes per other thread otherwise
+  */
+  std::vector<memory_stats> snapshot() {
+    std::lock_guard<std::mutex> lk(m_);
+    std::vector<memory_stats> result;
+    for (size_t id = 0; id != count_; ++id) {
+      memory_stats stats{tags_[id].name_.load(), tags_[id].live_.load(std::memory_order_relaxed),
+                         tags_[id].peak_.load(std::memory_order_relaxed),
+                         tags_[id].allocations_.load(std::memory_order_relaxed),
+                         tags_[id].reallocations_.load(std::memory_order_relaxed)};
+      for (const thread_counters *counters : threads_) {
+        stats.live_bytes += counters->pending_[id].load(std::memory_order_relaxed);
+        stats.allocations += counters->allocations_[id].load(std::memory_order_relaxed);
+        stats.reallocations += counters->reallocations_[id].load(std::memory_order_relaxed);
+      }
+      if (stats.live_bytes > stats.peak_bytes)
+        stats.peak_bytes = stats.live_bytes;
+      result.push_back(stats);
+    }
+    return result;
+  }
+
+private:
+  registry() { tags_[0].name_ = "untagged"; }
+
+  tag_totals tags_[max_tags];
+  size_t count_ = 1;
+  std::vector<thread_counters *> threads_;
+  std::mutex m_;
+};
+
+inline thread_counters::thread_counters() { registry::instance().add(this); }
+inline thread_counters::~thread_counters() { registry::instance().remove(this); }
+
+inline thread_counters &local_counters() {
+  thread_local thread_counters counters;
+  return counters;
+}
+
+// owner-only increment, a plain load and store instead of a locked read-modify-write
+template <typename T> inline void bump(std::atomic<T> &counter, T delta) {
+  counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace memory_accounting
+
+class memory_tag {
+public:
+  static constexpr bool enabled = true;
+
+  memory_tag() noexcept : id_(0) {}
+  explicit memory_tag(const char *name) : id_(memory_accounting::registry::instance().tag_id(name)) {}
+
+  void on_allocate(size_t bytes) const {
+    memory_accounting::thread_counters &counters = memory_accounting::local_counters();
+    memory_accounting::bump<uint64_t>(counters.allocations_[id_], 1);
+    add_bytes(counters, int64_t(bytes));
+  }
+
+  void on_deallocate(size_t bytes) const {
+    add_bytes(memory_accounting::local_counters(), -int64_t(bytes));
+  }
+
+  void on_reallocate() const {
+    memory_accounting::bump<uint64_t>(memory_accounting::local_counters().reallocations_[id_], 1);
+  }
+
+  const char *name() const { return memory_accounting::registry::instance().name(id_); }
+
+  friend bool operator==(const memory_tag &lhs, const memory_tag &rhs) { return lhs.id_ == rhs.id_; }
+  friend bool operator!=(const memory_tag &lhs, const memory_tag &rhs) { return !(lhs == rhs); }
+
+private:
+  void add_bytes(memory_accounting::thread_counters &counters, int64_t bytes) const {
+    memory_accounting::registry &registry = memory_accounting::registry::instance();
+    int64_t pending = counters.pending_[id_].load(std::memory_order_relaxed) + bytes;
+    if (pending >= memory_accounting::flush_bytes || pending <= -memory_accounting::flush_bytes) {
+      registry.flush(id_, pending);
+      pending = 0;
+    } else if (bytes > 0) {
+      registry.raise_peak(id_, registry.flushed_live(id_) + pending);
+    }
+    counters.pending_[id_].store(pending, std::memory_order_relaxed);
+  }
+
+  uint32_t id_;
+};
+
+inline std::vector<memory_stats> memory_snapshot() {
+  return memory_accounting::registry::instance().snapshot();
+}
+
+#else
+
+class memory_tag {
+public:
+  static constexpr bool enabled = false;
+
+  constexpr memory_tag() noexcept {}
+  constexpr explicit memory_tag(const char *) noexcept {}
+
+  void on_allocate(size_t) const noexcept {}
+  void on_deallocate(size_t) const noexcept {}
+  void on_reallocate() const noexcept {}
+
+  const char *name() const noexcept { return "untagged"; }
+
+  friend bool operator==(const memory_tag &, const memory_tag &) { return true; }
+  friend bool operator!=(const memory_tag &, const memory_tag &) { return false; }
+};
+
+inline std::vector<memory_stats> memory_snapshot() { return {}; }
+
+#endif
+
+/*
+std allocator reporting to a tag, for containers built on std ones (e.g. the serialized
+threadsafe_queue over std::queue)
+*/
+template <typename T> class tagged_allocator {
+public:
+  using value_type = T;
+  // the tag travels with the storage it accounted for
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  tagged_allocator(memory_tag tag = memory_tag()) noexcept : tag_(tag) {}
+  template <typename U> tagged_allocator(const tagged_allocator<U> &oth) noexcept : tag_(oth.tag_) {}
+
+  T *allocate(size_t n) {
+    T *p = std::allocator<T>().allocate(n);
+    tag_.on_allocate(n * sizeof(T));
+    return p;
+  }
+
+  void deallocate(T *p, size_t n) noexcept {
+    tag_.on_deallocate(n * sizeof(T));
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  // memory comes from std::allocator, so any two instances can free each other's blocks
+  friend bool operator==(const tagged_allocator &, const tagged_allocator &) { return true; }
+  friend bool operator!=(const tagged_allocator &, const tagged_allocator &) { return false; }
+
+private:
+  template <typename> friend class tagged_allocator;
+
+  [[no_unique_address]] memory_tag tag_;
+};
@@ -0,0 +1,123 @@
+#define BOOST_TEST_MODULE MemoryAccountingTests
+#define CONTAINERS_MEMORY_ACCOUNTING
+
+#include "./../forward_list/forward_list.cpp"
+#include "./../stack/stack.cpp"
+#include "./../threadsafe_queue/finegrained_queue.cpp"
+#include "./../vector/vector.cpp"
+#include "memory_accounting.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <vector>
+
+static memory_stats stats_of(const char *tag) {
+  for (const memory_stats &stats : memory_snapshot())
+    if (std::strcmp(stats.tag, tag) == 0)
+      return stats;
+  throw "tag not registered";
+}
+
+BOOST_AUTO_TEST_SUITE(MemoryAccountingTestSuite)
+
+BOOST_AUTO_TEST_CASE(Tags_AreRegisteredOnce) {
+  memory_tag a("tags.a");
+  memory_tag b("tags.b");
+  memory_tag again("tags.a");
+
+  BOOST_CHECK(a == again);
+  BOOST_CHECK(a != b);
+  BOOST_CHECK_EQUAL(a.name(), "tags.a");
+  BOOST_CHECK_EQUAL(memory_tag().name(), "untagged");
+}
+
+BOOST_AUTO_TEST_CASE(Vector_LiveBytesAndReallocations) {
+  memory_tag tag("vector");
+  {
+    vector<int> v(tag);
+    for (int i = 0; i != 100; ++i)
+      v.push_back(i);
+
+    memory_stats stats = stats_of("vector");
+    BOOST_CHECK_EQUAL(stats.live_bytes, int64_t(v.capacity() * sizeof(int)));
+    BOOST_CHECK_GT(stats.reallocations, 0);
+    BOOST_CHECK_GE(stats.peak_bytes, stats.live_bytes);
+
+    vector<int> copy(v); // the copy is accounted under the same tag
+    BOOST_CHECK_EQUAL(stats_of("vector").live_bytes, int64_t(2 * v.capacity() * sizeof(int)));
+  }
+  memory_stats stats = stats_of("vector");
+  BOOST_CHECK_EQUAL(stats.live_bytes, 0);
+  BOOST_CHECK_GT(stats.peak_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_AndForwardList) {
+  memory_tag stack_tag("stack");
+  memory_tag list_tag("forward_list");
+  {
+    stack<double> s(32, stack_tag);
+    forward_list<int> list(list_tag);
+    list.push_back(1);
+    list.push_front(2);
+
+    BOOST_CHECK_EQUAL(stats_of("stack").live_bytes, int64_t(32 * sizeof(double)));
+    BOOST_CHECK_EQUAL(stats_of("stack").allocations, 1);
+    // sentinel plus two nodes
+    BOOST_CHECK_EQUAL(stats_of("forward_list").allocations, 3);
+
+    list.pop_front();
+    BOOST_CHECK_EQUAL(stats_of("forward_list").allocations, 3);
+    BOOST_CHECK_LT(stats_of("forward_list").live_bytes, stats_of("forward_list").peak_bytes);
+  }
+  BOOST_CHECK_EQUAL(stats_of("stack").live_bytes, 0);
+  BOOST_CHECK_EQUAL(stats_of("forward_list").live_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadsafeQueue_AndTaggedAllocator) {
+  memory_tag tag("queue");
+  {
+    threadsafe_queue<int> queue(tag);
+    for (int i = 0; i != 10; ++i)
+      queue.push(i);
+    queue.try_pop();
+    BOOST_CHECK_EQUAL(stats_of("queue").allocations, 11); // the dummy node and ten pushes
+  }
+  BOOST_CHECK_EQUAL(stats_of("queue").live_bytes, 0);
+
+  memory_tag std_tag("std");
+  {
+    std::deque<int, tagged_allocator<int>> d{tagged_allocator<int>(std_tag)};
+    for (int i = 0; i != 1000; ++i)
+      d.push_back(i);
+    BOOST_CHECK_GT(stats_of("std").live_bytes, int64_t(1000 * sizeof(int)));
+  }
+  BOOST_CHECK_EQUAL(stats_of("std").live_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Threads_AreAggregated) {
+  memory_tag tag("threads");
+  std::vector<std::thread> threads;
+  std::vector<stack<char>> kept(4);
+
+  for (int t = 0; t != 4; ++t)
+    threads.emplace_back([&kept, tag, t]() {
+      // churn past the flush threshold, then keep one stack alive after the thread exits
+      for (int i = 0; i != 100; ++i)
+        stack<char> scratch(4096, tag);
+      kept[t] = stack<char>(1000, tag);
+    });
+  for (auto &th : threads)
+    th.join();
+
+  memory_stats stats = stats_of("threads");
+  BOOST_CHECK_EQUAL(stats.allocations, 4 * 101);
+  BOOST_CHECK_EQUAL(stats.live_bytes, 4 * 1000);
+  BOOST_CHECK_GE(stats.peak_bytes, 4 * 1000);
+
+  kept.clear(); // freed by this thread, balanced against the other threads' allocations
+  BOOST_CHECK_EQUAL(stats_of("threads").live_bytes, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
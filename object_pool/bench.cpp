@@ -0,0 +1,73 @@
+#include "./../benchmark.cpp"
+#include "object_pool.cpp"
+
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*
+churn: every thread keeps a window of live objects and replaces a random one per step,
+with new/delete, the shared pool and the pool behind a thread_cache
+usage: ./bench [steps per thread] [window]
+*/
+
+struct connection_buffer {
+  explicit connection_buffer(size_t id) : id_(id) { data_[0] = char(id); }
+
+  size_t id_;
+  char data_[504];
+};
+
+using pool_type = object_pool<connection_buffer>;
+
+template <typename Make> static void churn(size_t steps, size_t window, uint64_t seed, Make make) {
+  std::vector<decltype(make(0))> live;
+  for (size_t i = 0; i != window; ++i)
+    live.push_back(make(i));
+
+  uint64_t x = seed | 1;
+  size_t sum = 0;
+  for (size_t i = 0; i != steps; ++i) {
+    x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+    auto &slot = live[x % window];
+    slot = make(i); // the old object is destroyed after the new one is made
+    sum += slot->data_[0];
+  }
+  do_not_optimize(sum);
+}
+
+static double run(int threads, size_t steps, size_t window, int kind) {
+  pool_type pool;
+  return best_of(3, [&] {
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+      workers.emplace_back([&, t] {
+        if (kind == 0) {
+          churn(steps, window, t, [](size_t i) { return std::make_unique<connection_buffer>(i); });
+        } else if (kind == 1) {
+          churn(steps, window, t, [&](size_t i) { return pool.acquire(i); });
+        } else {
+          pool_type::thread_cache cache(pool);
+          churn(steps, window, t, [&](size_t i) { return pool.acquire(i); });
+        }
+      });
+    for (std::thread &w : workers)
+      w.join();
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t steps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+  size_t window = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+  std::printf("%zu replacements per thread, window of %zu 512-byte objects, %u hardware threads\n",
+              steps, window, std::thread::hardware_concurrency());
+  std::printf("%-8s %14s %14s %14s   (ns per replacement)\n", "threads", "new/delete", "pool",
+              "pool+cache");
+  for (int threads = 1; threads <= 8; threads *= 2) {
+    double n = double(steps) * threads;
+    std::printf("%-8d %14.2f %14.2f %14.2f\n", threads, run(threads, steps, window, 0) / n * 1e9,
+                run(threads, steps, window, 1) / n * 1e9, run(threads, steps, window, 2) / n * 1e9);
+  }
+}
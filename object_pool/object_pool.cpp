@@ -0,0 +1,278 @@
+#pragma once
+
+#include "./../stack/stack.cpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+/*
+pool of T recycled through a LIFO free list
+
+slots are allocated SlabSize at a time in slabs (raw stack_base storage) and never freed
+before the pool itself. a destroyed object's slot goes on top of a stack of free slots, so
+the next acquire() reuses the slot freed last, whose memory is most likely still in cache.
+acquire() constructs a T in a slot and returns a handle that destroys it and recycles the
+slot when it goes out of scope.
+
+the shared free list is guarded by a mutex. a thread that churns objects can put a
+thread_cache in front of it: while the cache lives, acquire() and handle destruction on
+that thread go to a private free list and only take the lock to move `batch` slots at a
+time from or to the shared one. a handle may be destroyed on any thread, its slot joins
+the free list of the thread that destroys it.
+
+the pool must outlive every handle and cache made from it.
+*/
+template <typename T, size_t SlabSize = 64>
+class object_pool
+{
+    static_assert(SlabSize > 0, "a slab needs room for at least one object");
+
+public:
+    class handle;
+    class thread_cache;
+
+    // the tag accounts the slabs and the pool's own bookkeeping
+    explicit object_pool(memory_tag tag = memory_tag())
+        : slabs_(0, tag), free_(0, tag), tag_(tag) {}
+
+    object_pool(const object_pool &) = delete;
+    object_pool &operator=(const object_pool &) = delete;
+
+    // the slabs go, every handle must already be gone
+    ~object_pool() = default;
+
+    template <typename... Args>
+    handle acquire(Args &&...args)
+    {
+        T *slot = allocate();
+        try
+        {
+            new (slot) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(slot);
+            throw;
+        }
+        return handle(this, slot);
+    }
+
+    /* allocates slabs until n free slots are available without allocating */
+    void reserve(size_t n)
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        while (free_.size() < n)
+            add_slab();
+    }
+
+    size_t slabs() const
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        return slabs_.size();
+    }
+
+    /* free slots in the shared list, slots held by thread caches are not counted */
+    size_t available() const
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        return free_.size();
+    }
+
+private:
+    T *allocate()
+    {
+        if (thread_cache *cache = find_cache())
+            return cache->allocate();
+        std::lock_guard<std::mutex> lk(m_);
+        if (free_.empty())
+            add_slab();
+        return free_.pop_value();
+    }
+
+    void deallocate(T *slot)
+    {
+        if (thread_cache *cache = find_cache())
+        {
+            cache->deallocate(slot);
+            return;
+        }
+        std::lock_guard<std::mutex> lk(m_);
+        free_.push(slot);
+    }
+
+    /* moves n free slots to out under one lock, allocating slabs as needed */
+    void take(T **out, size_t n)
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        while (free_.size() < n)
+            add_slab();
+        free_.pop_n(n, out);
+    }
+
+    /* returns [first, last) to the shared free list under one lock */
+    void give(T **first, T **last)
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        free_.push_range(first, last);
+    }
+
+    // called with m_ held
+    void add_slab()
+    {
+        stack_base<T> slab(SlabSize, tag_);
+        // room for every slot the pool owns, so giving slots back never allocates
+        size_t slots = (slabs_.size() + 1) * SlabSize;
+        if (free_.capacity() < slots)
+            free_.reserve(std::max(slots, 2 * free_.capacity()));
+        slabs_.push(std::move(slab));
+        // pushed from the end, so the slab is handed out in address order
+        for (T *slot = slabs_.top().capacity_; slot != slabs_.top().start_;)
+            free_.push(--slot);
+    }
+
+    thread_cache *find_cache() const
+    {
+        for (thread_cache *cache = current_cache_; cache != nullptr; cache = cache->prev_)
+            if (&cache->pool_ == this)
+                return cache;
+        return nullptr;
+    }
+
+    // innermost live thread_cache of this thread, shared by all pools of this type
+    static inline thread_local thread_cache *current_cache_ = nullptr;
+
+    stack<stack_base<T>> slabs_;
+    stack<T *> free_; // top is the slot freed last
+    mutable std::mutex m_;
+    [[no_unique_address]] memory_tag tag_;
+};
+
+/*
+owner of one pooled object, destroys it and recycles its slot when it goes out of scope
+*/
+template <typename T, size_t SlabSize>
+class object_pool<T, SlabSize>::handle
+{
+public:
+    handle() noexcept : pool_(nullptr), ptr_(nullptr) {}
+
+    handle(const handle &) = delete;
+    handle &operator=(const handle &) = delete;
+
+    handle(handle &&oth) noexcept : handle() { swap(*this, oth); }
+
+    handle &operator=(handle &&oth) noexcept
+    {
+        // move-and-swap idiom
+        handle tmp(std::move(oth));
+        swap(*this, tmp);
+        return *this;
+    }
+
+    ~handle() { reset(); }
+
+    friend void swap(handle &lhs, handle &rhs) noexcept
+    {
+        using std::swap;
+        swap(lhs.pool_, rhs.pool_);
+        swap(lhs.ptr_, rhs.ptr_);
+    }
+
+    /* destroys the object now, the handle becomes empty */
+    void reset() noexcept
+    {
+        if (ptr_)
+        {
+            ptr_->~T();
+            pool_->deallocate(std::exchange(ptr_, nullptr));
+        }
+    }
+
+    T *get() const noexcept { return ptr_; }
+    T &operator*() const noexcept { return *ptr_; }
+    T *operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+private:
+    friend class object_pool;
+
+    handle(object_pool *pool, T *ptr) noexcept : pool_(pool), ptr_(ptr) {}
+
+    object_pool *pool_;
+    T *ptr_;
+};
+
+/*
+per-thread free list in front of a pool, for the thread that constructs it
+
+it holds up to 2 * batch slots: an empty cache takes batch slots from the pool, a full one
+gives batch back, so a thread that allocates and frees at a steady rate locks the pool
+once per batch operations at most. caches of one thread nest and must be destroyed in
+reverse order of construction on that thread; the destructor returns every slot.
+*/
+template <typename T, size_t SlabSize>
+class object_pool<T, SlabSize>::thread_cache
+{
+public:
+    explicit thread_cache(object_pool &pool, size_t batch = 32)
+        : pool_(pool), batch_(batch ? batch : 1), transfer_(new T *[batch_]), prev_(current_cache_)
+    {
+        slots_.reserve(2 * batch_);
+        current_cache_ = this;
+    }
+
+    thread_cache(const thread_cache &) = delete;
+    thread_cache &operator=(const thread_cache &) = delete;
+
+    ~thread_cache()
+    {
+        current_cache_ = prev_;
+        flush();
+    }
+
+    /* returns every cached slot to the pool */
+    void flush()
+    {
+        while (!slots_.empty())
+        {
+            size_t n = slots_.size() < batch_ ? slots_.size() : batch_;
+            slots_.pop_n(n, transfer_.get());
+            pool_.give(transfer_.get(), transfer_.get() + n);
+        }
+    }
+
+    size_t size() const noexcept { return slots_.size(); }
+
+private:
+    friend class object_pool;
+
+    T *allocate()
+    {
+        if (slots_.empty())
+        {
+            pool_.take(transfer_.get(), batch_);
+            slots_.push_range(transfer_.get(), transfer_.get() + batch_);
+        }
+        return slots_.pop_value();
+    }
+
+    void deallocate(T *slot)
+    {
+        if (slots_.size() == 2 * batch_)
+        {
+            // the slot being freed stays here, on top
+            slots_.pop_n(batch_, transfer_.get());
+            pool_.give(transfer_.get(), transfer_.get() + batch_);
+        }
+        slots_.push(slot);
+    }
+
+    object_pool &pool_;
+    size_t batch_;
+    stack<T *> slots_;
+    std::unique_ptr<T *[]> transfer_; // staging area for batch moves
+    thread_cache *prev_;              // enclosing cache of this thread
+};
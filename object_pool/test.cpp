@@ -0,0 +1,221 @@
+#define BOOST_TEST_MODULE ObjectPoolTests
+#define CONTAINERS_MEMORY_ACCOUNTING
+
+#include "object_pool.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// allocations and reallocations made under tag, the pool's slabs and free list included
+static uint64_t allocations(const char *tag)
+{
+    for (const memory_stats &stats : memory_snapshot())
+        if (std::strcmp(stats.tag, tag) == 0)
+            return stats.allocations + stats.reallocations;
+    throw "tag not registered";
+}
+
+struct Tracked
+{
+    static inline std::atomic<int> live = 0;
+
+    explicit Tracked(int x = 0) : x_(x)
+    {
+        if (x == -1)
+            throw std::runtime_error("bad value");
+        ++live;
+    }
+    ~Tracked() { --live; }
+
+    int x_;
+    char payload_[60];
+};
+
+BOOST_AUTO_TEST_SUITE(ObjectPoolTestSuite)
+
+BOOST_AUTO_TEST_CASE(HandleDestroysObject)
+{
+    object_pool<Tracked> pool;
+    {
+        auto h = pool.acquire(7);
+        BOOST_CHECK(h);
+        BOOST_CHECK_EQUAL(h->x_, 7);
+        BOOST_CHECK_EQUAL((*h).x_, 7);
+        BOOST_CHECK_EQUAL(Tracked::live, 1);
+    }
+    BOOST_CHECK_EQUAL(Tracked::live, 0);
+
+    auto h = pool.acquire(1);
+    h.reset();
+    BOOST_CHECK(!h);
+    BOOST_CHECK_EQUAL(Tracked::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReusesTheSlotFreedLast)
+{
+    object_pool<Tracked, 4> pool;
+    auto a = pool.acquire(1);
+    auto b = pool.acquire(2);
+    Tracked *freed = b.get();
+    b.reset();
+    auto c = pool.acquire(3);
+    BOOST_CHECK_EQUAL(c.get(), freed);
+
+    // a fresh slab hands out slots in address order
+    BOOST_CHECK_EQUAL(c.get(), a.get() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsBySlabs)
+{
+    object_pool<Tracked, 4> pool;
+    std::vector<object_pool<Tracked, 4>::handle> handles;
+    for (int i = 0; i != 9; ++i)
+        handles.push_back(pool.acquire(i));
+    BOOST_CHECK_EQUAL(pool.slabs(), 3);
+    BOOST_CHECK_EQUAL(pool.available(), 3);
+
+    std::set<Tracked *> distinct;
+    for (auto &h : handles)
+        distinct.insert(h.get());
+    BOOST_CHECK_EQUAL(distinct.size(), 9);
+
+    handles.clear();
+    BOOST_CHECK_EQUAL(pool.available(), 12);
+    BOOST_CHECK_EQUAL(Tracked::live, 0);
+
+    pool.reserve(20);
+    BOOST_CHECK_EQUAL(pool.slabs(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(ReleasingEverySlotDoesNotAllocate)
+{
+    object_pool<Tracked, 4> pool(memory_tag("pool.release"));
+    std::vector<object_pool<Tracked, 4>::handle> handles;
+    handles.reserve(12);
+    // every slot of each slab is taken before the next slab is added
+    for (int i = 0; i != 12; ++i)
+        handles.push_back(pool.acquire(i));
+    BOOST_CHECK_EQUAL(pool.slabs(), 3);
+    BOOST_CHECK_EQUAL(pool.available(), 0);
+
+    uint64_t before = allocations("pool.release");
+    BOOST_CHECK(before >= 3); // the slabs at least
+    handles.clear();
+    BOOST_CHECK_EQUAL(allocations("pool.release"), before);
+    BOOST_CHECK_EQUAL(pool.available(), 12);
+
+    // the same through a thread cache giving its batches back
+    {
+        object_pool<Tracked, 4>::thread_cache cache(pool, 2);
+        for (int i = 0; i != 12; ++i)
+            handles.push_back(pool.acquire(i));
+        before = allocations("pool.release");
+        handles.clear();
+    }
+    BOOST_CHECK_EQUAL(allocations("pool.release"), before);
+    BOOST_CHECK_EQUAL(pool.available(), 12);
+    BOOST_CHECK_EQUAL(Tracked::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(HandlesMoveAndSwap)
+{
+    object_pool<Tracked> pool;
+    auto a = pool.acquire(1);
+    auto b = std::move(a);
+    BOOST_CHECK(!a);
+    BOOST_CHECK_EQUAL(b->x_, 1);
+
+    auto c = pool.acquire(2);
+    swap(b, c);
+    BOOST_CHECK_EQUAL(b->x_, 2);
+    BOOST_CHECK_EQUAL(c->x_, 1);
+
+    b = std::move(c);
+    BOOST_CHECK_EQUAL(Tracked::live, 1);
+    BOOST_CHECK_EQUAL(b->x_, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ThrowingConstructorReturnsTheSlot)
+{
+    object_pool<Tracked, 4> pool;
+    pool.reserve(1);
+    BOOST_CHECK_THROW(pool.acquire(-1), std::runtime_error);
+    BOOST_CHECK_EQUAL(pool.available(), 4);
+    BOOST_CHECK_EQUAL(Tracked::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadCacheMovesSlotsInBatches)
+{
+    object_pool<Tracked, 16> pool;
+    {
+        object_pool<Tracked, 16>::thread_cache cache(pool, 4);
+        auto h = pool.acquire(1);
+        BOOST_CHECK_EQUAL(cache.size(), 3); // one batch taken, one slot handed out
+        BOOST_CHECK_EQUAL(pool.available(), 12);
+
+        std::vector<object_pool<Tracked, 16>::handle> handles;
+        for (int i = 0; i != 10; ++i)
+            handles.push_back(pool.acquire(i));
+        handles.clear();
+        BOOST_CHECK_LE(cache.size(), 8); // never more than two batches
+        BOOST_CHECK_EQUAL(cache.size() + pool.available() + 1, 16);
+    }
+    // the cache returned everything, the handle freed after it went to the pool
+    BOOST_CHECK_EQUAL(pool.available(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadCachesNest)
+{
+    object_pool<Tracked, 8> first, second;
+    object_pool<Tracked, 8>::thread_cache outer(first, 2);
+    {
+        object_pool<Tracked, 8>::thread_cache inner(second, 2);
+        auto a = first.acquire(1);
+        auto b = second.acquire(2);
+        BOOST_CHECK_EQUAL(outer.size(), 1);
+        BOOST_CHECK_EQUAL(inner.size(), 1);
+    }
+    BOOST_CHECK_EQUAL(second.available(), 8);
+    BOOST_CHECK_EQUAL(first.available(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentChurnWithCrossThreadRelease)
+{
+    using pool_type = object_pool<Tracked, 32>;
+    pool_type pool;
+    const int threads = 4, rounds = 5000;
+    std::vector<std::vector<pool_type::handle>> handed_over(threads);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t != threads; ++t)
+        workers.emplace_back([&, t] {
+            pool_type::thread_cache cache(pool, 8);
+            std::vector<pool_type::handle> live;
+            for (int i = 0; i != rounds; ++i)
+            {
+                live.push_back(pool.acquire(i));
+                if (live.size() == 16)
+                    live.erase(live.begin(), live.begin() + 8);
+            }
+            handed_over[t] = std::move(live);
+        });
+    for (std::thread &w : workers)
+        w.join();
+
+    // released here, on a thread with no cache
+    size_t kept = 0;
+    for (auto &v : handed_over)
+        kept += v.size();
+    BOOST_CHECK_EQUAL(size_t(Tracked::live.load()), kept);
+    handed_over.clear();
+    BOOST_CHECK_EQUAL(Tracked::live, 0);
+    BOOST_CHECK_EQUAL(pool.available(), pool.slabs() * 32);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
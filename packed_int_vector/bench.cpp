@@ -0,0 +1,47 @@
+#include "./../benchmark.cpp"
+#include "packed_int_vector.cpp"
+
+#include <cstdlib>
+#include <vector>
+
+/*
+reports compression ratio and decode throughput for sorted sequences with different gap sizes
+usage: ./bench [count]
+*/
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+  std::printf("%12s %10s %12s %14s %16s\n", "max gap", "ratio", "bits/int", "decode GB/s",
+              "random ns/op");
+
+  for (uint64_t max_gap : {0ull, 15ull, 255ull, 65535ull, 1ull << 31, 1ull << 40}) {
+    std::uniform_int_distribution<uint64_t> gap(0, max_gap);
+    packed_int_vector packed;
+    uint64_t cur = 0;
+    for (size_t i = 0; i != count; ++i)
+      packed.push_back(cur += gap(bench_rng()));
+
+    std::vector<uint64_t> out(count);
+    double decode = best_of(5, [&] {
+      packed.decode(out.data());
+      do_not_optimize(out.back());
+    });
+
+    const size_t lookups = 1'000'000;
+    std::vector<size_t> indexes(lookups);
+    std::uniform_int_distribution<size_t> index(0, count - 1);
+    for (auto &i : indexes)
+      i = index(bench_rng());
+
+    double random = best_of(3, [&] {
+      uint64_t sum = 0;
+      for (size_t i : indexes)
+        sum += packed[i];
+      do_not_optimize(sum);
+    });
+
+    std::printf("%12llu %10.2f %12.2f %14.2f %16.1f\n", (unsigned long long)max_gap,
+                packed.compression_ratio(), 8.0 * packed.size_bytes() / count,
+                count * sizeof(uint64_t) / decode / 1e9, random / lookups * 1e9);
+  }
+}
@@ -0,0 +1,248 @@
+#include "./../vector/vector.cpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+compressed vector of non-decreasing 64 bit integers
+
+values are grouped into blocks of 128. a block keeps its first value as base and
+stores the 128 deltas bit-packed with the smallest width that fits the largest delta.
+deltas are laid out vertically in 4 lanes (delta i lives in lane i % 4), so one 128 bit
+load unpacks 4 consecutive deltas at once.
+
+values that do not yet fill a block stay uncompressed in the tail buffer.
+*/
+class packed_int_vector {
+public:
+  static constexpr size_t block_size = 128;
+  static constexpr size_t lanes = 4;
+  static constexpr uint8_t raw_width = 64; // deltas wider than 32 bits are stored unpacked
+
+  packed_int_vector() : last_(0), size_(0), tail_size_(0) {}
+
+  /* strong exception safety guarantee */
+  void push_back(uint64_t val) {
+    if (size_ && val < last_)
+      throw "packed_int_vector values must be non-decreasing";
+
+    tail_[tail_size_] = val;
+    if (tail_size_ + 1 == block_size) {
+      encode_block(tail_);
+      tail_size_ = 0;
+    } else {
+      ++tail_size_;
+    }
+
+    last_ = val;
+    ++size_;
+  }
+
+  template <typename Iter> void append(Iter first, Iter last) {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  /* random access decodes the block holding index */
+  uint64_t operator[](size_t index) const {
+    size_t block = index / block_size;
+    if (block == block_count())
+      return tail_[index % block_size];
+
+    uint64_t buffer[block_size];
+    decode_block(block, buffer);
+    return buffer[index % block_size];
+  }
+
+  uint64_t at(size_t index) const {
+    if (index >= size_)
+      throw "index out of range";
+    return (*this)[index];
+  }
+
+  uint64_t back() const {
+    if (empty())
+      throw "empty packed_int_vector";
+    return last_;
+  }
+
+  /* writes all size() values to out */
+  void decode(uint64_t *out) const {
+    for (size_t block = 0; block != block_count(); ++block, out += block_size)
+      decode_block(block, out);
+    std::memcpy(out, tail_, tail_size_ * sizeof(uint64_t));
+  }
+
+  /* writes the block_size values of a full block to out */
+  void decode_block(size_t block, uint64_t *out) const {
+    const uint32_t *in = words_.data() + offsets_[block];
+    uint64_t base = bases_[block];
+    unsigned width = widths_[block];
+
+    if (width == 0) {
+      for (size_t i = 0; i != block_size; ++i)
+        out[i] = base;
+    } else if (width == raw_width) {
+      uint64_t acc = base;
+      for (size_t i = 0; i != block_size; ++i) {
+        acc += uint64_t(in[2 * i]) | (uint64_t(in[2 * i + 1]) << 32);
+        out[i] = acc;
+      }
+    } else {
+      unpack(in, width, base, out);
+    }
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return 0 == size_; }
+  size_t block_count() const noexcept { return bases_.size(); }
+
+  /* bytes held by the encoded representation, including block metadata and tail */
+  size_t size_bytes() const noexcept {
+    return words_.size() * sizeof(uint32_t) + bases_.size() * sizeof(uint64_t) +
+           offsets_.size() * sizeof(size_t) + widths_.size() * sizeof(uint8_t) +
+           tail_size_ * sizeof(uint64_t);
+  }
+
+  /* uncompressed size divided by compressed size */
+  double compression_ratio() const noexcept {
+    return size_bytes() ? double(size_ * sizeof(uint64_t)) / size_bytes() : 1.0;
+  }
+
+private:
+  static uint32_t width_mask(unsigned width) noexcept {
+    return width == 32 ? ~uint32_t(0) : (uint32_t(1) << width) - 1;
+  }
+
+  /* packs deltas so that delta k * lanes + lane starts at bit k * width of its lane */
+  static void pack(const uint64_t *deltas, unsigned width, uint32_t *out) {
+    for (size_t lane = 0; lane != lanes; ++lane) {
+      for (size_t k = 0; k != block_size / lanes; ++k) {
+        uint32_t delta = uint32_t(deltas[k * lanes + lane]);
+        size_t bit = k * width;
+        uint32_t *word = out + (bit / 32) * lanes + lane;
+        unsigned shift = bit % 32;
+
+        word[0] |= delta << shift;
+        if (shift + width > 32)
+          word[lanes] |= delta >> (32 - shift);
+      }
+    }
+  }
+
+#ifdef __SSE2__
+  /* unpacks 4 deltas per step and turns them into values with a 64 bit prefix sum */
+  static void unpack(const uint32_t *in, unsigned width, uint64_t base, uint64_t *out) {
+    const __m128i *src = reinterpret_cast<const __m128i *>(in);
+    const __m128i mask = _mm_set1_epi32(int(width_mask(width)));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_set1_epi64x(int64_t(base));
+    __m128i cur = _mm_loadu_si128(src++);
+    unsigned shift = 0;
+
+    for (size_t k = 0; k != block_size / lanes; ++k) {
+      __m128i delta = _mm_srl_epi32(cur, _mm_cvtsi32_si128(int(shift)));
+      shift += width;
+      if (shift >= 32) {
+        shift -= 32;
+        if (k + 1 != block_size / lanes) {
+          cur = _mm_loadu_si128(src++);
+          if (shift)
+            delta = _mm_or_si128(delta, _mm_sll_epi32(cur, _mm_cvtsi32_si128(int(width - shift))));
+        }
+      }
+      delta = _mm_and_si128(delta, mask);
+
+      __m128i lo = _mm_unpacklo_epi32(delta, zero); // deltas 0, 1 as 64 bit
+      __m128i hi = _mm_unpackhi_epi32(delta, zero); // deltas 2, 3 as 64 bit
+
+      lo = _mm_add_epi64(_mm_add_epi64(lo, _mm_slli_si128(lo, 8)), acc);
+      acc = _mm_unpackhi_epi64(lo, lo);
+      hi = _mm_add_epi64(_mm_add_epi64(hi, _mm_slli_si128(hi, 8)), acc);
+      acc = _mm_unpackhi_epi64(hi, hi);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + k * lanes), lo);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + k * lanes + 2), hi);
+    }
+  }
+#else
+  static void unpack(const uint32_t *in, unsigned width, uint64_t base, uint64_t *out) {
+    const uint32_t mask = width_mask(width);
+    uint64_t acc = base;
+
+    for (size_t k = 0; k != block_size / lanes; ++k) {
+      size_t bit = k * width;
+      const uint32_t *word = in + (bit / 32) * lanes;
+      unsigned shift = bit % 32;
+
+      for (size_t lane = 0; lane != lanes; ++lane) {
+        uint64_t delta = word[lane] >> shift;
+        if (shift + width > 32)
+          delta |= uint64_t(word[lanes + lane]) << (32 - shift);
+        acc += delta & mask;
+        out[k * lanes + lane] = acc;
+      }
+    }
+  }
+#endif
+
+  /* grows v geometrically so that appending n more elements does not reallocate */
+  template <typename T> static void reserve_more(vector<T> &v, size_t n) {
+    if (v.size() + n > v.capacity())
+      v.reserve(std::max(v.size() + n, 2 * v.capacity()));
+  }
+
+  /* strong exception safety guarantee: all allocations happen before any state changes */
+  void encode_block(const uint64_t *vals) {
+    uint64_t deltas[block_size];
+    uint64_t max_delta = 0;
+
+    deltas[0] = 0;
+    for (size_t i = 1; i != block_size; ++i) {
+      deltas[i] = vals[i] - vals[i - 1];
+      max_delta = std::max(max_delta, deltas[i]);
+    }
+
+    unsigned width = std::bit_width(max_delta);
+    if (width > 32)
+      width = raw_width;
+    size_t word_count = width == raw_width ? 2 * block_size : lanes * width;
+
+    reserve_more(words_, word_count);
+    reserve_more(bases_, 1);
+    reserve_more(offsets_, 1);
+    reserve_more(widths_, 1);
+
+    size_t offset = words_.size();
+    words_.resize(offset + word_count, 0);
+    uint32_t *out = words_.data() + offset;
+
+    if (width == raw_width) {
+      for (size_t i = 0; i != block_size; ++i) {
+        out[2 * i] = uint32_t(deltas[i]);
+        out[2 * i + 1] = uint32_t(deltas[i] >> 32);
+      }
+    } else if (width) {
+      pack(deltas, width, out);
+    }
+
+    bases_.push_back(vals[0]);
+    offsets_.push_back(offset);
+    widths_.push_back(uint8_t(width));
+  }
+
+  vector<uint32_t> words_;  // bit-packed deltas of all full blocks
+  vector<uint64_t> bases_;  // first value of every block
+  vector<size_t> offsets_;  // index into words_ where every block begins
+  vector<uint8_t> widths_;  // delta bit width of every block, raw_width if unpacked
+  uint64_t tail_[block_size]; // values not yet encoded into a block
+  uint64_t last_;             // most recently pushed value
+  size_t size_;
+  size_t tail_size_;
+};
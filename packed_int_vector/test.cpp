@@ -0,0 +1,114 @@
+#define BOOST_TEST_MODULE PackedIntVectorTests
+
+#include "packed_int_vector.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// builds a sorted sequence whose gaps are drawn from [0, max_gap]
+static std::vector<uint64_t> sorted_values(size_t n, uint64_t max_gap, uint64_t start = 0) {
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<uint64_t> gap(0, max_gap);
+  std::vector<uint64_t> values(n);
+  uint64_t cur = start;
+  for (auto &v : values)
+    v = cur += gap(rng);
+  return values;
+}
+
+static void check_round_trip(const std::vector<uint64_t> &values) {
+  packed_int_vector v;
+  v.append(values.begin(), values.end());
+  BOOST_REQUIRE_EQUAL(v.size(), values.size());
+
+  std::vector<uint64_t> decoded(values.size());
+  v.decode(decoded.data());
+  BOOST_CHECK(decoded == values);
+
+  for (size_t i = 0; i < values.size(); i += 37)
+    BOOST_CHECK_EQUAL(v[i], values[i]);
+}
+
+BOOST_AUTO_TEST_SUITE(PackedIntVectorTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization) {
+  packed_int_vector v;
+  BOOST_CHECK(v.empty());
+  BOOST_CHECK_EQUAL(v.size(), 0);
+  BOOST_CHECK_EQUAL(v.block_count(), 0);
+  BOOST_CHECK_THROW(v.back(), const char *);
+  BOOST_CHECK_THROW(v.at(0), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(PushBack_TailOnly) {
+  packed_int_vector v;
+  v.push_back(5);
+  v.push_back(9);
+  v.push_back(9);
+
+  BOOST_CHECK_EQUAL(v.size(), 3);
+  BOOST_CHECK_EQUAL(v.block_count(), 0);
+  BOOST_CHECK_EQUAL(v[0], 5);
+  BOOST_CHECK_EQUAL(v[1], 9);
+  BOOST_CHECK_EQUAL(v.back(), 9);
+}
+
+BOOST_AUTO_TEST_CASE(PushBack_Decreasing_Throws) {
+  packed_int_vector v;
+  v.push_back(10);
+  BOOST_CHECK_THROW(v.push_back(9), const char *);
+  BOOST_CHECK_EQUAL(v.size(), 1);
+  BOOST_CHECK_EQUAL(v.back(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(BlockBoundary) {
+  std::vector<uint64_t> values = sorted_values(packed_int_vector::block_size + 1, 100);
+  packed_int_vector v;
+  v.append(values.begin(), values.end());
+
+  BOOST_CHECK_EQUAL(v.block_count(), 1);
+  BOOST_CHECK_EQUAL(v[packed_int_vector::block_size - 1], values[packed_int_vector::block_size - 1]);
+  BOOST_CHECK_EQUAL(v[packed_int_vector::block_size], values.back());
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip_ConstantValues) {
+  check_round_trip(std::vector<uint64_t>(1000, 123456789));
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip_AllWidths) {
+  // every delta width from 1 to 32 bits, each spanning several blocks
+  for (unsigned width = 1; width <= 32; ++width)
+    check_round_trip(sorted_values(3 * packed_int_vector::block_size + 17,
+                                   (uint64_t(1) << width) - 1, uint64_t(1) << 40));
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip_WideDeltas) {
+  // gaps above 32 bits fall back to unpacked blocks
+  check_round_trip(sorted_values(1000, uint64_t(1) << 40));
+}
+
+BOOST_AUTO_TEST_CASE(Compression_SmallGaps) {
+  std::vector<uint64_t> values = sorted_values(100000, 15);
+  packed_int_vector v;
+  v.append(values.begin(), values.end());
+
+  // 4 bit deltas plus per-block metadata should be well below the raw size
+  BOOST_CHECK(v.compression_ratio() > 8.0);
+}
+
+BOOST_AUTO_TEST_CASE(CopyConstruction) {
+  std::vector<uint64_t> values = sorted_values(500, 1000);
+  packed_int_vector v1;
+  v1.append(values.begin(), values.end());
+
+  packed_int_vector v2(v1);
+  v1.push_back(values.back() + 1);
+
+  BOOST_CHECK_EQUAL(v2.size(), values.size());
+  BOOST_CHECK_EQUAL(v2[499], values[499]);
+  BOOST_CHECK_EQUAL(v1.size(), values.size() + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
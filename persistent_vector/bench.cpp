@@ -0,0 +1,58 @@
+#include "./../benchmark.cpp"
+#include "persistent_vector.cpp"
+
+#include <cstdlib>
+#include <vector>
+
+/*
+cost of keeping one version per single-element update: a deep copy of vector against a
+persistent_vector version, plus batched updates through a transient
+usage: ./bench [elements]
+*/
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+  const size_t versions = 1000;
+
+  vector<int> base(n, 0);
+  persistent_vector<int> pbase;
+  {
+    transient_vector<int> t = pbase.transient();
+    for (size_t i = 0; i != n; ++i)
+      t.push_back(int(i));
+    pbase = t.persistent();
+  }
+
+  std::uniform_int_distribution<size_t> index(0, n - 1);
+  std::vector<size_t> updates(versions);
+  for (auto &i : updates)
+    i = index(bench_rng());
+
+  double copy = time_it([&] {
+    std::vector<vector<int>> history;
+    history.push_back(base);
+    for (size_t i : updates) {
+      history.push_back(history.back());
+      history.back()[i] = 1;
+    }
+    do_not_optimize(history.back()[0]);
+  });
+
+  double persistent = time_it([&] {
+    std::vector<persistent_vector<int>> history{pbase};
+    for (size_t i : updates)
+      history.push_back(history.back().set(i, 1));
+    do_not_optimize(history.back()[0]);
+  });
+
+  double transient = time_it([&] {
+    transient_vector<int> t = pbase.transient();
+    for (size_t i : updates)
+      t.set(i, 1);
+    do_not_optimize(t.persistent()[0]);
+  });
+
+  std::printf("%zu elements, %zu versions (us per version)\n", n, versions);
+  std::printf("%-28s %12.2f\n", "vector deep copy", copy / versions * 1e6);
+  std::printf("%-28s %12.2f\n", "persistent_vector::set", persistent / versions * 1e6);
+  std::printf("%-28s %12.2f\n", "transient batch (per edit)", transient / versions * 1e6);
+}
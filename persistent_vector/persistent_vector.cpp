@@ -0,0 +1,338 @@
+#include "./../vector/vector.cpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+template <typename T> class transient_vector;
+
+/*
+immutable vector whose versions share structure
+
+elements live in a 32-way trie of shared nodes plus a tail leaf holding the last up to 32
+elements. push_back(), set() and pop_back() return a new version that copies only the
+O(log32 n) nodes on the path to the change, every other node is shared with the source.
+
+a transient_vector applies a batch of edits in place to the nodes it created itself and
+turns back into a persistent_vector in O(1).
+*/
+template <typename T> class persistent_vector {
+  static constexpr unsigned bits = 5;
+  static constexpr size_t width = size_t(1) << bits;
+  static constexpr size_t mask = width - 1;
+
+  // edit == 0 marks a node as shared, a transient may only mutate nodes carrying its own id
+  struct leaf {
+    explicit leaf(uint64_t edit) : edit_(edit) { values_.reserve(width); }
+    leaf(const leaf &oth, uint64_t edit) : edit_(edit), values_(oth.values_) {
+      values_.reserve(width);
+    }
+
+    uint64_t edit_;
+    vector<T> values_;
+  };
+
+  struct branch {
+    explicit branch(uint64_t edit) : edit_(edit) {}
+    branch(const branch &oth, uint64_t edit) : edit_(edit) {
+      for (size_t i = 0; i != width; ++i)
+        children_[i] = oth.children_[i];
+    }
+
+    uint64_t edit_;
+    std::shared_ptr<void> children_[width]; // branches, or leaves on the lowest level
+  };
+
+public:
+  persistent_vector() : size_(0), shift_(bits), root_(new branch(0)), tail_(new leaf(0)) {}
+
+  persistent_vector push_back(const T &val) const {
+    persistent_vector result(*this);
+    result.push_back(val, 0);
+    return result;
+  }
+
+  persistent_vector set(size_t index, const T &val) const {
+    check_index(index);
+    persistent_vector result(*this);
+    result.set(index, val, 0);
+    return result;
+  }
+
+  persistent_vector pop_back() const {
+    if (empty())
+      throw "empty persistent_vector";
+    persistent_vector result(*this);
+    result.pop_back(0);
+    return result;
+  }
+
+  /* starts a batch of in-place edits, this version stays unchanged */
+  transient_vector<T> transient() const { return transient_vector<T>(*this); }
+
+  const T &operator[](size_t index) const { return leaf_for(index)->values_[index & mask]; }
+
+  const T &at(size_t index) const {
+    check_index(index);
+    return (*this)[index];
+  }
+
+  const T &back() const {
+    if (empty())
+      throw "empty persistent_vector";
+    return tail_->values_.back();
+  }
+
+  /* visits the elements in order, one leaf at a time */
+  template <typename Func> void for_each(Func &&func) const {
+    for (size_t i = 0; i < tail_offset(); i += width)
+      for (const T &val : leaf_for(i)->values_)
+        func(val);
+    for (const T &val : tail_->values_)
+      func(val);
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return 0 == size_; }
+
+private:
+  friend class transient_vector<T>;
+
+  void check_index(size_t index) const {
+    if (index >= size_)
+      throw "index out of range";
+  }
+
+  /* index of the first element kept in the tail */
+  size_t tail_offset() const noexcept { return size_ < width ? 0 : ((size_ - 1) >> bits) << bits; }
+
+  static branch *as_branch(const std::shared_ptr<void> &node) { return static_cast<branch *>(node.get()); }
+  static leaf *as_leaf(const std::shared_ptr<void> &node) { return static_cast<leaf *>(node.get()); }
+
+  leaf *leaf_for(size_t index) const {
+    if (index >= tail_offset())
+      return tail_.get();
+
+    branch *node = root_.get();
+    for (unsigned level = shift_; level > bits; level -= bits)
+      node = as_branch(node->children_[(index >> level) & mask]);
+    return as_leaf(node->children_[(index >> bits) & mask]);
+  }
+
+  /* returns node itself if edit owns it, otherwise a copy owned by edit */
+  template <typename Node> static std::shared_ptr<Node> editable(const std::shared_ptr<Node> &node, uint64_t edit) {
+    if (edit && node->edit_ == edit)
+      return node;
+    return std::make_shared<Node>(*node, edit);
+  }
+
+  /* chain of single-child branches from level down to the leaf */
+  static std::shared_ptr<void> new_path(unsigned level, std::shared_ptr<void> node, uint64_t edit) {
+    if (level == 0)
+      return node;
+    auto result = std::make_shared<branch>(edit);
+    result->children_[0] = new_path(level - bits, std::move(node), edit);
+    return result;
+  }
+
+  /* the following mutate *this in place, copying every node that edit does not own */
+
+  void push_back(const T &val, uint64_t edit) {
+    if (size_ - tail_offset() < width) {
+      tail_ = editable(tail_, edit);
+      tail_->values_.push_back(val);
+      ++size_;
+      return;
+    }
+
+    auto new_tail = std::make_shared<leaf>(edit);
+    new_tail->values_.push_back(val);
+
+    // the full tail moves into the trie, which gains a level when the root is full
+    if ((size_ >> bits) > (size_t(1) << shift_)) {
+      auto new_root = std::make_shared<branch>(edit);
+      new_root->children_[0] = root_;
+      new_root->children_[1] = new_path(shift_, tail_, edit);
+      root_ = std::move(new_root);
+      shift_ += bits;
+    } else {
+      root_ = push_tail(shift_, root_, tail_, edit);
+    }
+
+    tail_ = std::move(new_tail);
+    ++size_;
+  }
+
+  std::shared_ptr<branch> push_tail(unsigned level, const std::shared_ptr<branch> &parent,
+                                    std::shared_ptr<void> tail, uint64_t edit) {
+    auto result = editable(parent, edit);
+    size_t sub = ((size_ - 1) >> level) & mask;
+
+    if (level == bits) {
+      result->children_[sub] = std::move(tail);
+    } else if (auto &child = parent->children_[sub]) {
+      result->children_[sub] = push_tail(level - bits, std::static_pointer_cast<branch>(child),
+                                         std::move(tail), edit);
+    } else {
+      result->children_[sub] = new_path(level - bits, std::move(tail), edit);
+    }
+    return result;
+  }
+
+  void set(size_t index, const T &val, uint64_t edit) {
+    if (index >= tail_offset()) {
+      tail_ = editable(tail_, edit);
+      tail_->values_[index & mask] = val;
+      return;
+    }
+    root_ = set(shift_, root_, index, val, edit);
+  }
+
+  static std::shared_ptr<branch> set(unsigned level, const std::shared_ptr<branch> &node, size_t index,
+                                     const T &val, uint64_t edit) {
+    auto result = editable(node, edit);
+    size_t sub = (index >> level) & mask;
+
+    if (level == bits) {
+      auto child = editable(std::static_pointer_cast<leaf>(node->children_[sub]), edit);
+      child->values_[index & mask] = val;
+      result->children_[sub] = std::move(child);
+    } else {
+      result->children_[sub] =
+          set(level - bits, std::static_pointer_cast<branch>(node->children_[sub]), index, val, edit);
+    }
+    return result;
+  }
+
+  void pop_back(uint64_t edit) {
+    if (size_ - tail_offset() > 1) {
+      tail_ = editable(tail_, edit);
+      tail_->values_.pop_back();
+      --size_;
+      return;
+    }
+
+    if (size_ == 1) {
+      *this = persistent_vector();
+      return;
+    }
+
+    // the tail empties, the rightmost leaf of the trie becomes the new tail
+    std::shared_ptr<leaf> new_tail =
+        std::static_pointer_cast<leaf>(leaf_shared_ptr(size_ - 2));
+    std::shared_ptr<branch> new_root = pop_tail(shift_, root_, edit);
+    if (!new_root)
+      new_root = std::make_shared<branch>(edit);
+
+    if (shift_ > bits && !new_root->children_[1]) {
+      new_root = std::static_pointer_cast<branch>(new_root->children_[0]);
+      shift_ -= bits;
+    }
+
+    root_ = std::move(new_root);
+    tail_ = std::move(new_tail);
+    --size_;
+  }
+
+  std::shared_ptr<branch> pop_tail(unsigned level, const std::shared_ptr<branch> &node, uint64_t edit) {
+    size_t sub = ((size_ - 2) >> level) & mask;
+
+    if (level > bits) {
+      auto child = pop_tail(level - bits, std::static_pointer_cast<branch>(node->children_[sub]), edit);
+      if (!child && sub == 0)
+        return nullptr;
+      auto result = editable(node, edit);
+      result->children_[sub] = std::move(child);
+      return result;
+    }
+
+    if (sub == 0)
+      return nullptr;
+    auto result = editable(node, edit);
+    result->children_[sub] = nullptr;
+    return result;
+  }
+
+  /* owning pointer to the trie leaf holding index */
+  std::shared_ptr<void> leaf_shared_ptr(size_t index) const {
+    branch *node = root_.get();
+    for (unsigned level = shift_; level > bits; level -= bits)
+      node = as_branch(node->children_[(index >> level) & mask]);
+    return node->children_[(index >> bits) & mask];
+  }
+
+  size_t size_;
+  unsigned shift_;              // bit offset of the root level, bits for a one-level trie
+  std::shared_ptr<branch> root_;
+  std::shared_ptr<leaf> tail_;  // the last 1 to 32 elements, empty only when size_ is 0
+};
+
+/*
+mutable view of a persistent_vector for batched edits
+
+nodes created by this transient are tagged with its id and edited in place, nodes shared
+with persistent versions are copied once on first touch. persistent() freezes the result;
+the transient may not be used afterwards.
+*/
+template <typename T> class transient_vector {
+public:
+  // a copy would share the id and edit the same nodes, so a transient can only be moved
+  transient_vector(const transient_vector &) = delete;
+  transient_vector &operator=(const transient_vector &) = delete;
+
+  transient_vector(transient_vector &&oth) noexcept : vec_(std::move(oth.vec_)), edit_(oth.edit_) {
+    oth.edit_ = 0;
+  }
+
+  transient_vector &push_back(const T &val) {
+    check_editable();
+    vec_.push_back(val, edit_);
+    return *this;
+  }
+
+  transient_vector &set(size_t index, const T &val) {
+    check_editable();
+    vec_.check_index(index);
+    vec_.set(index, val, edit_);
+    return *this;
+  }
+
+  transient_vector &pop_back() {
+    check_editable();
+    if (vec_.empty())
+      throw "empty transient_vector";
+    vec_.pop_back(edit_);
+    return *this;
+  }
+
+  const T &operator[](size_t index) const { return vec_[index]; }
+  size_t size() const noexcept { return vec_.size(); }
+  bool empty() const noexcept { return vec_.empty(); }
+
+  /* ends the batch, later edits through this transient throw */
+  persistent_vector<T> persistent() {
+    check_editable();
+    edit_ = 0;
+    return vec_;
+  }
+
+private:
+  friend class persistent_vector<T>;
+
+  explicit transient_vector(const persistent_vector<T> &vec) : vec_(vec), edit_(next_edit()) {}
+
+  // ids are never reused, so a node can never be claimed by a later transient
+  static uint64_t next_edit() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+  }
+
+  void check_editable() const {
+    if (edit_ == 0)
+      throw "transient used after persistent()";
+  }
+
+  persistent_vector<T> vec_;
+  uint64_t edit_;
+};
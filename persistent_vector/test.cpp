@@ -0,0 +1,134 @@
+#define BOOST_TEST_MODULE PersistentVectorTests
+
+#include "persistent_vector.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+template <typename T> static std::vector<T> to_std(const persistent_vector<T> &v) {
+  std::vector<T> result;
+  v.for_each([&](const T &val) { result.push_back(val); });
+  return result;
+}
+
+static persistent_vector<int> make_range(int n) {
+  persistent_vector<int> v;
+  for (int i = 0; i != n; ++i)
+    v = v.push_back(i);
+  return v;
+}
+
+BOOST_AUTO_TEST_SUITE(PersistentVectorTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization) {
+  persistent_vector<int> v;
+  BOOST_CHECK(v.empty());
+  BOOST_CHECK_EQUAL(v.size(), 0);
+  BOOST_CHECK_THROW(v.back(), const char *);
+  BOOST_CHECK_THROW(v.at(0), const char *);
+  BOOST_CHECK_THROW(v.pop_back(), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(PushBack_OldVersionUnchanged) {
+  persistent_vector<std::string> v0;
+  persistent_vector<std::string> v1 = v0.push_back("a");
+  persistent_vector<std::string> v2 = v1.push_back("b");
+
+  BOOST_CHECK_EQUAL(v0.size(), 0);
+  BOOST_CHECK_EQUAL(v1.size(), 1);
+  BOOST_CHECK_EQUAL(v2.size(), 2);
+  BOOST_CHECK_EQUAL(v1.back(), "a");
+  BOOST_CHECK_EQUAL(v2[0], "a");
+  BOOST_CHECK_EQUAL(v2[1], "b");
+}
+
+BOOST_AUTO_TEST_CASE(PushBack_AcrossTrieLevels) {
+  // 32 * 32 + 32 fills the first root, 32^3 + 32 adds a third level
+  const int n = 32 * 32 * 32 + 100;
+  persistent_vector<int> v = make_range(n);
+
+  BOOST_CHECK_EQUAL(v.size(), n);
+  for (int i = 0; i != n; ++i)
+    BOOST_REQUIRE_EQUAL(v[i], i);
+  BOOST_CHECK_EQUAL(v.back(), n - 1);
+}
+
+BOOST_AUTO_TEST_CASE(Set_SharesEverythingElse) {
+  persistent_vector<int> v = make_range(5000);
+  persistent_vector<int> changed = v.set(10, -1).set(4999, -2).set(2048, -3);
+
+  BOOST_CHECK_EQUAL(changed[10], -1);
+  BOOST_CHECK_EQUAL(changed[4999], -2);
+  BOOST_CHECK_EQUAL(changed[2048], -3);
+  BOOST_CHECK_EQUAL(changed[11], 11);
+
+  BOOST_CHECK_EQUAL(v[10], 10);
+  BOOST_CHECK_EQUAL(v[4999], 4999);
+  BOOST_CHECK_EQUAL(v[2048], 2048);
+  BOOST_CHECK_THROW(v.set(5000, 0), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(PopBack_ToEmpty) {
+  const int n = 32 * 32 + 70;
+  persistent_vector<int> v = make_range(n);
+  persistent_vector<int> original = v;
+
+  for (int i = n; i != 0; --i) {
+    BOOST_REQUIRE_EQUAL(v.size(), i);
+    BOOST_REQUIRE_EQUAL(v.back(), i - 1);
+    BOOST_REQUIRE_EQUAL(v[i / 2], i / 2);
+    v = v.pop_back();
+  }
+  BOOST_CHECK(v.empty());
+
+  // every intermediate version was independent of the original
+  BOOST_CHECK_EQUAL(original.size(), n);
+  BOOST_CHECK_EQUAL(original.back(), n - 1);
+
+  // pop then push again reuses the same layout
+  persistent_vector<int> regrown = original.pop_back().pop_back().push_back(7);
+  BOOST_CHECK_EQUAL(regrown.size(), n - 1);
+  BOOST_CHECK_EQUAL(regrown.back(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(Transient_BatchEdits) {
+  persistent_vector<int> base = make_range(100);
+
+  transient_vector<int> t = base.transient();
+  for (int i = 100; i != 3000; ++i)
+    t.push_back(i);
+  t.set(0, -1).set(2999, -2).pop_back();
+  persistent_vector<int> edited = t.persistent();
+
+  BOOST_CHECK_EQUAL(edited.size(), 2999);
+  BOOST_CHECK_EQUAL(edited[0], -1);
+  BOOST_CHECK_EQUAL(edited.back(), 2998);
+
+  // the source version is untouched
+  BOOST_CHECK_EQUAL(base.size(), 100);
+  BOOST_CHECK_EQUAL(base[0], 0);
+
+  BOOST_CHECK_THROW(t.push_back(1), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(Transient_DoesNotLeakIntoSnapshots) {
+  transient_vector<int> t = persistent_vector<int>().transient();
+  for (int i = 0; i != 2000; ++i)
+    t.push_back(i);
+  persistent_vector<int> snapshot = t.persistent();
+
+  // a second transient must copy the nodes the first one created
+  transient_vector<int> t2 = snapshot.transient();
+  for (int i = 0; i != 2000; ++i)
+    t2.set(i, -i);
+  persistent_vector<int> negated = t2.persistent();
+
+  std::vector<int> expected(2000);
+  for (int i = 0; i != 2000; ++i)
+    expected[i] = i;
+  BOOST_CHECK(to_std(snapshot) == expected);
+  BOOST_CHECK_EQUAL(negated[1999], -1999);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
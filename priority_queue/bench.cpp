@@ -0,0 +1,74 @@
+#include "./../benchmark.cpp"
+#include "priority_queue.cpp"
+
+#include <cstdlib>
+#include <queue>
+#include <vector>
+
+/*
+arity sweep against std::priority_queue (a binary heap over std::vector)
+  build      bulk heapify from a range
+  push+pop   n pushes then n pops
+  pop_push   n fused replace-top operations on a full heap
+usage: ./bench [elements]
+*/
+
+template <typename Heap> static double build(const std::vector<uint64_t> &input) {
+  return best_of(3, [&] {
+    Heap heap(input.begin(), input.end());
+    do_not_optimize(heap.top());
+  });
+}
+
+template <typename Heap> static double push_pop(const std::vector<uint64_t> &input) {
+  return best_of(3, [&] {
+    Heap heap;
+    if constexpr (requires { heap.reserve(input.size()); })
+      heap.reserve(input.size());
+    for (uint64_t x : input)
+      heap.push(x);
+    uint64_t sum = 0;
+    while (!heap.empty()) {
+      sum += heap.top();
+      heap.pop();
+    }
+    do_not_optimize(sum);
+  });
+}
+
+template <typename Heap> static double replace_top(const std::vector<uint64_t> &input) {
+  Heap heap(input.begin(), input.end());
+  return best_of(3, [&] {
+    uint64_t sum = 0;
+    for (uint64_t x : input) {
+      if constexpr (requires { heap.pop_push(x); }) {
+        sum += heap.pop_push(x >> 1);
+      } else {
+        sum += heap.top();
+        heap.pop();
+        heap.push(x >> 1);
+      }
+    }
+    do_not_optimize(sum);
+  });
+}
+
+template <typename Heap> static void row(const char *name, const std::vector<uint64_t> &input) {
+  double n = double(input.size());
+  std::printf("%-24s %12.1f %12.1f %12.1f\n", name, build<Heap>(input) / n * 1e9,
+              push_pop<Heap>(input) / n * 1e9, replace_top<Heap>(input) / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+  std::vector<uint64_t> input(n);
+  for (auto &x : input)
+    x = bench_rng()();
+
+  std::printf("%zu elements (ns per element)\n", n);
+  std::printf("%-24s %12s %12s %12s\n", "", "build", "push+pop", "pop_push");
+  row<std::priority_queue<uint64_t>>("std::priority_queue", input);
+  row<priority_queue<uint64_t, 2>>("priority_queue<2>", input);
+  row<priority_queue<uint64_t, 4>>("priority_queue<4>", input);
+  row<priority_queue<uint64_t, 8>>("priority_queue<8>", input);
+}
@@ -0,0 +1,291 @@
+#include "./../vector/vector.cpp"
+
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+/*
+d-ary heap over vector
+
+each node has Arity children stored next to each other, so a sift-down touches one cache
+line per level for Arity * sizeof(T) <= 64 and the heap is log2(Arity) times shallower than
+a binary one. pushes get cheaper with the lower depth, pops compare Arity children per level.
+like std::priority_queue, top() is the largest element under Compare.
+*/
+template <typename T, size_t Arity = 4, typename Compare = std::less<T>> class priority_queue {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
+public:
+  explicit priority_queue(const Compare &comp = Compare()) : comp_(comp) {}
+
+  /* builds the heap from [first, last) bottom-up in O(n) */
+  template <typename InputIt>
+  priority_queue(InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp) {
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                    typename std::iterator_traits<InputIt>::iterator_category>)
+      data_.reserve(std::distance(first, last));
+    for (; first != last; ++first)
+      data_.push_back(*first);
+    make_heap();
+  }
+
+  void push(const T &val) {
+    data_.push_back(val);
+    sift_up(data_.size() - 1);
+  }
+
+  void pop() {
+    check_not_empty();
+    T val = std::move(data_.back());
+    data_.pop_back();
+    if (!data_.empty())
+      replace_top(std::move(val));
+  }
+
+  /* removes and returns top() then inserts val, with a single sift-down */
+  T pop_push(const T &val) {
+    check_not_empty();
+    T result = std::move(data_.front());
+    data_.front() = val;
+    sift_down(0);
+    return result;
+  }
+
+  const T &top() const {
+    check_not_empty();
+    return data_.front();
+  }
+
+  void reserve(size_t capacity) { data_.reserve(capacity); }
+
+  size_t size() const noexcept { return data_.size(); }
+  bool empty() const noexcept { return data_.empty(); }
+
+private:
+  void check_not_empty() const {
+    if (data_.empty())
+      throw "empty priority_queue";
+  }
+
+  void make_heap() {
+    if (data_.size() < 2)
+      return;
+    for (size_t i = (data_.size() - 2) / Arity + 1; i-- != 0;)
+      sift_down(i);
+  }
+
+  /*
+  the last element, re-inserted at the root by pop(), almost always sinks back to the
+  bottom, so instead of comparing it on every level the hole at the root follows the best
+  children down to a leaf and val then climbs back up the few levels it needs
+  */
+  void replace_top(T &&val) {
+    const size_t n = data_.size();
+    size_t index = 0;
+    for (size_t first = 1; first < n; first = index * Arity + 1) {
+      size_t best = first;
+      size_t last = first + Arity < n ? first + Arity : n;
+      for (size_t child = first + 1; child < last; ++child)
+        if (comp_(data_[best], data_[child]))
+          best = child;
+      data_[index] = std::move(data_[best]);
+      index = best;
+    }
+    sift_up(index, std::move(val));
+  }
+
+  void sift_up(size_t index) { sift_up(index, std::move(data_[index])); }
+
+  /* moves val up from the hole at index, shifting the parents it passes down */
+  void sift_up(size_t index, T &&moved) {
+    T val = std::move(moved);
+    while (index != 0) {
+      size_t parent = (index - 1) / Arity;
+      if (!comp_(data_[parent], val))
+        break;
+      data_[index] = std::move(data_[parent]);
+      index = parent;
+    }
+    data_[index] = std::move(val);
+  }
+
+  void sift_down(size_t index) {
+    const size_t n = data_.size();
+    T val = std::move(data_[index]);
+
+    for (;;) {
+      size_t first = index * Arity + 1;
+      if (first >= n)
+        break;
+
+      size_t best = first;
+      size_t last = first + Arity < n ? first + Arity : n;
+      for (size_t child = first + 1; child < last; ++child)
+        if (comp_(data_[best], data_[child]))
+          best = child;
+
+      if (!comp_(val, data_[best]))
+        break;
+      data_[index] = std::move(data_[best]);
+      index = best;
+    }
+    data_[index] = std::move(val);
+  }
+
+  vector<T> data_;
+  [[no_unique_address]] Compare comp_;
+};
+
+/*
+d-ary heap of (id, priority) pairs with a position map
+
+ids are dense indices in [0, n): pos_[id] is the heap slot holding id, so the priority of a
+queued id can be changed in O(log n) without searching. raise_priority() moves an id
+towards top(), which with the default std::less means a larger priority and with
+std::greater (a min-heap, where it is the textbook decrease-key) a smaller one; update()
+moves it either way.
+*/
+template <typename T, size_t Arity = 4, typename Compare = std::less<T>>
+class indexed_priority_queue {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  struct entry {
+    size_t id_;
+    T priority_;
+  };
+
+public:
+  explicit indexed_priority_queue(size_t ids = 0, const Compare &comp = Compare())
+      : pos_(ids, npos), comp_(comp) {}
+
+  void push(size_t id, const T &priority) {
+    if (contains(id))
+      throw "id already queued";
+    if (id >= pos_.size())
+      pos_.resize(id < 2 * pos_.size() ? 2 * pos_.size() : id + 1, npos);
+
+    heap_.push_back(entry{id, priority});
+    pos_[id] = heap_.size() - 1;
+    sift_up(heap_.size() - 1);
+  }
+
+  void pop() {
+    check_not_empty();
+    remove_at(0);
+  }
+
+  size_t top() const {
+    check_not_empty();
+    return heap_.front().id_;
+  }
+
+  const T &top_priority() const {
+    check_not_empty();
+    return heap_.front().priority_;
+  }
+
+  /* the new priority may only move id towards top(), e.g. a larger one under std::less */
+  void raise_priority(size_t id, const T &priority) {
+    size_t index = position(id);
+    if (comp_(priority, heap_[index].priority_))
+      throw "raise_priority would move the id away from top";
+    heap_[index].priority_ = priority;
+    sift_up(index);
+  }
+
+  /* sets a new priority in either direction */
+  void update(size_t id, const T &priority) {
+    size_t index = position(id);
+    bool towards_top = comp_(heap_[index].priority_, priority);
+    heap_[index].priority_ = priority;
+    if (towards_top)
+      sift_up(index);
+    else
+      sift_down(index);
+  }
+
+  void erase(size_t id) { remove_at(position(id)); }
+
+  const T &priority(size_t id) const { return heap_[position(id)].priority_; }
+
+  bool contains(size_t id) const noexcept { return id < pos_.size() && pos_[id] != npos; }
+
+  size_t size() const noexcept { return heap_.size(); }
+  bool empty() const noexcept { return heap_.empty(); }
+
+private:
+  void check_not_empty() const {
+    if (heap_.empty())
+      throw "empty priority_queue";
+  }
+
+  size_t position(size_t id) const {
+    if (!contains(id))
+      throw "id not queued";
+    return pos_[id];
+  }
+
+  void place(size_t index, entry &&e) {
+    pos_[e.id_] = index;
+    heap_[index] = std::move(e);
+  }
+
+  void remove_at(size_t index) {
+    pos_[heap_[index].id_] = npos;
+    size_t last = heap_.size() - 1;
+    if (index != last) {
+      place(index, std::move(heap_[last]));
+      heap_.pop_back();
+      // the moved entry may belong above or below its new slot
+      if (index != 0 && comp_(heap_[(index - 1) / Arity].priority_, heap_[index].priority_))
+        sift_up(index);
+      else
+        sift_down(index);
+      return;
+    }
+    heap_.pop_back();
+  }
+
+  void sift_up(size_t index) {
+    entry e = std::move(heap_[index]);
+    while (index != 0) {
+      size_t parent = (index - 1) / Arity;
+      if (!comp_(heap_[parent].priority_, e.priority_))
+        break;
+      place(index, std::move(heap_[parent]));
+      index = parent;
+    }
+    place(index, std::move(e));
+  }
+
+  void sift_down(size_t index) {
+    const size_t n = heap_.size();
+    entry e = std::move(heap_[index]);
+
+    for (;;) {
+      size_t first = index * Arity + 1;
+      if (first >= n)
+        break;
+
+      size_t best = first;
+      size_t last = first + Arity < n ? first + Arity : n;
+      for (size_t child = first + 1; child < last; ++child)
+        if (comp_(heap_[best].priority_, heap_[child].priority_))
+          best = child;
+
+      if (!comp_(e.priority_, heap_[best].priority_))
+        break;
+      place(index, std::move(heap_[best]));
+      index = best;
+    }
+    place(index, std::move(e));
+  }
+
+  vector<entry> heap_;
+  vector<size_t> pos_; // heap slot of every id, npos when the id is not queued
+  [[no_unique_address]] Compare comp_;
+};
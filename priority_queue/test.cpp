@@ -0,0 +1,174 @@
+#define BOOST_TEST_MODULE PriorityQueueTests
+
+#include "priority_queue.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+template <size_t Arity> static void check_against_std(int n) {
+  std::mt19937 rng(Arity);
+  std::vector<int> input(n);
+  for (int &x : input)
+    x = int(rng() % 1000);
+
+  priority_queue<int, Arity> heap(input.begin(), input.end());
+  std::priority_queue<int> expected(input.begin(), input.end());
+
+  for (int i = 0; i != n / 2; ++i) {
+    int val = int(rng() % 1000);
+    heap.push(val);
+    expected.push(val);
+  }
+  BOOST_REQUIRE_EQUAL(heap.size(), expected.size());
+  while (!expected.empty()) {
+    BOOST_REQUIRE_EQUAL(heap.top(), expected.top());
+    heap.pop();
+    expected.pop();
+  }
+  BOOST_CHECK(heap.empty());
+}
+
+BOOST_AUTO_TEST_SUITE(PriorityQueueTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization) {
+  priority_queue<int> heap;
+  BOOST_CHECK(heap.empty());
+  BOOST_CHECK_THROW(heap.top(), const char *);
+  BOOST_CHECK_THROW(heap.pop(), const char *);
+  BOOST_CHECK_THROW(heap.pop_push(1), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(MatchesStdPriorityQueue) {
+  check_against_std<2>(1000);
+  check_against_std<3>(1000);
+  check_against_std<4>(1000);
+  check_against_std<8>(1000);
+  check_against_std<8>(1);
+}
+
+BOOST_AUTO_TEST_CASE(CustomCompare_MinHeap) {
+  std::vector<std::string> words{"pear", "apple", "fig", "kiwi"};
+  priority_queue<std::string, 4, std::greater<std::string>> heap(words.begin(), words.end());
+
+  BOOST_CHECK_EQUAL(heap.top(), "apple");
+  heap.pop();
+  BOOST_CHECK_EQUAL(heap.top(), "fig");
+}
+
+BOOST_AUTO_TEST_CASE(PopPush) {
+  std::vector<int> input{5, 1, 9, 3};
+  priority_queue<int, 2> heap(input.begin(), input.end());
+
+  BOOST_CHECK_EQUAL(heap.pop_push(4), 9);
+  BOOST_CHECK_EQUAL(heap.size(), 4);
+  BOOST_CHECK_EQUAL(heap.top(), 5);
+
+  // a value larger than everything comes straight back on the next pop_push
+  BOOST_CHECK_EQUAL(heap.pop_push(100), 5);
+  BOOST_CHECK_EQUAL(heap.pop_push(0), 100);
+  BOOST_CHECK_EQUAL(heap.top(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(Indexed_PushPopInPriorityOrder) {
+  indexed_priority_queue<int, 4, std::greater<int>> heap;
+  heap.push(3, 30);
+  heap.push(0, 10);
+  heap.push(7, 70);
+  heap.push(1, 20);
+
+  BOOST_CHECK_THROW(heap.push(3, 1), const char *);
+  BOOST_CHECK(heap.contains(7));
+  BOOST_CHECK(!heap.contains(2));
+  BOOST_CHECK(!heap.contains(1000));
+
+  std::vector<size_t> order;
+  while (!heap.empty()) {
+    order.push_back(heap.top());
+    heap.pop();
+  }
+  BOOST_CHECK((order == std::vector<size_t>{0, 1, 3, 7}));
+  BOOST_CHECK(!heap.contains(3));
+}
+
+BOOST_AUTO_TEST_CASE(Indexed_RaisePriorityUpdateErase) {
+  indexed_priority_queue<int, 2, std::greater<int>> heap(8);
+  for (size_t id = 0; id != 8; ++id)
+    heap.push(id, int(10 * id + 10));
+
+  heap.raise_priority(6, 5); // decrease-key of a min-heap
+  BOOST_CHECK_EQUAL(heap.top(), 6);
+  BOOST_CHECK_EQUAL(heap.top_priority(), 5);
+  BOOST_CHECK_THROW(heap.raise_priority(6, 50), const char *);
+
+  heap.update(6, 1000);
+  BOOST_CHECK_EQUAL(heap.top(), 0);
+  BOOST_CHECK_EQUAL(heap.priority(6), 1000);
+
+  heap.erase(0);
+  heap.erase(3);
+  BOOST_CHECK_THROW(heap.erase(3), const char *);
+  BOOST_CHECK_EQUAL(heap.size(), 6);
+
+  std::vector<size_t> order;
+  while (!heap.empty()) {
+    order.push_back(heap.top());
+    heap.pop();
+  }
+  BOOST_CHECK((order == std::vector<size_t>{1, 2, 4, 5, 7, 6}));
+}
+
+BOOST_AUTO_TEST_CASE(Indexed_RaisePriorityWithDefaultCompare) {
+  // std::less makes a max-heap: a larger priority moves the id towards top()
+  indexed_priority_queue<int> heap(4);
+  for (size_t id = 0; id != 4; ++id)
+    heap.push(id, int(10 * id));
+  BOOST_CHECK_EQUAL(heap.top(), 3);
+
+  heap.raise_priority(0, 100);
+  BOOST_CHECK_EQUAL(heap.top(), 0);
+  heap.raise_priority(1, 10); // an equal priority is allowed
+  BOOST_CHECK_THROW(heap.raise_priority(2, 5), const char *);
+  BOOST_CHECK_EQUAL(heap.priority(2), 20);
+
+  // lowering one goes through update()
+  heap.update(0, -1);
+  BOOST_CHECK_EQUAL(heap.top(), 3);
+  std::vector<size_t> order;
+  while (!heap.empty()) {
+    order.push_back(heap.top());
+    heap.pop();
+  }
+  BOOST_CHECK((order == std::vector<size_t>{3, 2, 1, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(Indexed_RandomizedAgainstSort) {
+  std::mt19937 rng(7);
+  const size_t n = 2000;
+  indexed_priority_queue<unsigned, 8, std::greater<unsigned>> heap;
+  std::vector<unsigned> priority(n);
+
+  for (size_t id = 0; id != n; ++id) {
+    priority[id] = rng() % 100000;
+    heap.push(id, priority[id]);
+  }
+  for (size_t i = 0; i != n; ++i) {
+    size_t id = rng() % n;
+    priority[id] = rng() % 100000;
+    heap.update(id, priority[id]);
+  }
+
+  unsigned last = 0;
+  while (!heap.empty()) {
+    size_t id = heap.top();
+    BOOST_REQUIRE_EQUAL(heap.top_priority(), priority[id]);
+    BOOST_REQUIRE_GE(priority[id], last);
+    last = priority[id];
+    heap.pop();
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
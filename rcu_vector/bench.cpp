@@ -0,0 +1,105 @@
+#include "./../benchmark.cpp"
+#include "rcu_vector.cpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+reader throughput with and without a writer republishing the table, against readers
+taking a mutex around a plain vector
+usage: ./bench [max readers]
+*/
+
+class mutex_vector
+{
+public:
+    explicit mutex_vector(vector<uint64_t> init) : data_(std::move(init)) {}
+
+    template <typename Func>
+    decltype(auto) read(Func &&func) const
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        return func(data_);
+    }
+
+    void store(vector<uint64_t> next)
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        data_ = std::move(next);
+    }
+
+private:
+    vector<uint64_t> data_;
+    mutable std::mutex m_;
+};
+
+// million lookups per second summed over all readers
+template <typename Table>
+double run(Table &table, int readers, bool with_writer, size_t table_size)
+{
+    const size_t lookups = 2'000'000;
+    std::atomic<bool> go{false}, stop{false};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t != readers; ++t)
+        threads.emplace_back([&, t]()
+                             {
+            std::mt19937_64 rng(t);
+            uint64_t sum = 0;
+            while (!go.load())
+                ;
+            for (size_t i = 0; i != lookups; ++i)
+            {
+                size_t index = rng() % table_size;
+                sum += table.read([index](const vector<uint64_t> &data)
+                                  { return data[index]; });
+            }
+            do_not_optimize(sum); });
+
+    std::thread writer;
+    if (with_writer)
+        writer = std::thread([&]()
+                             {
+            uint64_t version = 0;
+            while (!stop.load())
+            {
+                table.store(vector<uint64_t>(table_size, ++version));
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } });
+
+    double seconds = time_it([&]()
+                             {
+        go = true;
+        for (auto &th : threads)
+            th.join(); });
+
+    stop = true;
+    if (writer.joinable())
+        writer.join();
+    return readers * lookups / seconds / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    int max_readers = argc > 1 ? std::atoi(argv[1]) : 16;
+    const size_t table_size = 4096;
+
+    std::printf("%8s %8s %16s %16s   (million reads per second)\n", "readers", "writer", "rcu",
+                "mutex");
+
+    for (bool with_writer : {false, true})
+    {
+        for (int readers = 1; readers <= max_readers; readers *= 2)
+        {
+            rcu_vector<uint64_t> rcu(vector<uint64_t>(table_size, 0));
+            mutex_vector locked(vector<uint64_t>(table_size, 0));
+
+            std::printf("%8d %8s %16.2f %16.2f\n", readers, with_writer ? "yes" : "no",
+                        run(rcu, readers, with_writer, table_size),
+                        run(locked, readers, with_writer, table_size));
+        }
+    }
+}
@@ -0,0 +1,178 @@
+#include "./../vector/vector.cpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/*
+read-mostly vector with read-copy-update semantics
+
+the current contents are an immutable vector reached through one atomic pointer. readers
+announce themselves in a per-slot counter, load the pointer and read without any lock;
+entering and leaving a read section is one fetch_add each, so readers are wait-free and
+never wait for writers.
+writers are serialized by a mutex, build the next version off to the side, publish it with
+a single pointer store and free the old version once every reader that could still see it
+has left its read section (a grace period).
+*/
+template <typename T, size_t ReaderSlots = 64>
+class rcu_vector
+{
+private:
+    // readers of the two epochs count into separate counters so a writer waits only for
+    // readers older than its update; padded so that readers on different slots never
+    // share a cache line
+    struct alignas(64) reader_slot
+    {
+        std::atomic<uint64_t> active_[2] = {0, 0};
+    };
+
+public:
+    /*
+    RAII read section pinning one version
+    the version stays valid and unchanged until the snapshot is destroyed, updates keep
+    publishing newer versions meanwhile but cannot finish while a snapshot is held
+    */
+    class snapshot
+    {
+    public:
+        snapshot(snapshot &&oth) noexcept : slot_(oth.slot_), parity_(oth.parity_), data_(oth.data_)
+        {
+            oth.slot_ = nullptr;
+        }
+
+        snapshot(const snapshot &) = delete;
+        snapshot &operator=(const snapshot &) = delete;
+        snapshot &operator=(snapshot &&) = delete;
+
+        ~snapshot()
+        {
+            if (slot_)
+                slot_->active_[parity_].fetch_sub(1, std::memory_order_release);
+        }
+
+        const T &operator[](size_t index) const noexcept { return (*data_)[index]; }
+        const T *begin() const noexcept { return data_->begin(); }
+        const T *end() const noexcept { return data_->end(); }
+        size_t size() const noexcept { return data_->size(); }
+        bool empty() const noexcept { return data_->empty(); }
+
+    private:
+        friend class rcu_vector;
+
+        snapshot(reader_slot *slot, unsigned parity, const vector<T> *data)
+            : slot_(slot), parity_(parity), data_(data) {}
+
+        reader_slot *slot_;
+        unsigned parity_;
+        const vector<T> *data_;
+    };
+
+    // default constructor
+    rcu_vector() : current_(new vector<T>()) {}
+
+    explicit rcu_vector(vector<T> init) : current_(new vector<T>(std::move(init))) {}
+
+    // copy and assignment are deleted, readers hold pointers into this object
+    rcu_vector(const rcu_vector &) = delete;
+    rcu_vector &operator=(const rcu_vector &) = delete;
+
+    ~rcu_vector() { delete current_.load(); }
+
+    snapshot read() const
+    {
+        reader_slot &slot = slots_[slot_index()];
+        unsigned parity = epoch_.load(std::memory_order_relaxed) & 1;
+
+        // seq_cst orders the announcement before the pointer load, pairing with the
+        // writer's pointer store before it scans the counters
+        slot.active_[parity].fetch_add(1, std::memory_order_seq_cst);
+        return snapshot(&slot, parity, current_.load(std::memory_order_seq_cst));
+    }
+
+    // runs func(const vector<T> &) inside a read section and returns its result
+    template <typename Func>
+    decltype(auto) read(Func &&func) const
+    {
+        snapshot s = read();
+        return func(*s.data_);
+    }
+
+    // replaces the contents, blocks until the previous version is reclaimed
+    void store(vector<T> next)
+    {
+        std::lock_guard<std::mutex> lk(writer_m_);
+        publish(new vector<T>(std::move(next)));
+    }
+
+    // applies func(vector<T> &) to a private copy of the current version and publishes it
+    template <typename Func>
+    void update(Func &&func)
+    {
+        std::lock_guard<std::mutex> lk(writer_m_);
+        vector<T> *next = new vector<T>(*current_.load(std::memory_order_relaxed));
+        try
+        {
+            func(*next);
+        }
+        catch (...)
+        {
+            delete next;
+            throw;
+        }
+        publish(next);
+    }
+
+    // must not be called by a thread holding a snapshot, the grace period would never end
+    void synchronize()
+    {
+        std::lock_guard<std::mutex> lk(writer_m_);
+        wait_for_readers();
+    }
+
+private:
+    void publish(vector<T> *next)
+    {
+        vector<T> *old = current_.exchange(next, std::memory_order_seq_cst);
+        wait_for_readers();
+        delete old;
+    }
+
+    /*
+    grace period: a reader that loaded the old pointer announced itself before the exchange,
+    in one of the two counters. flipping the epoch steers new readers to the other counter,
+    so each wait below only drains readers that were already inside and always finishes
+    */
+    void wait_for_readers()
+    {
+        for (int round = 0; round != 2; ++round)
+        {
+            unsigned parity = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+            while (active_readers(parity) != 0)
+                std::this_thread::yield();
+        }
+    }
+
+    uint64_t active_readers(unsigned parity) const
+    {
+        uint64_t total = 0;
+        for (const reader_slot &slot : slots_)
+            total += slot.active_[parity].load(std::memory_order_seq_cst);
+        return total;
+    }
+
+    // threads are spread over the slots in the order they first read
+    static size_t slot_index()
+    {
+        static std::atomic<size_t> next_thread{0};
+        thread_local size_t index = next_thread.fetch_add(1, std::memory_order_relaxed) % ReaderSlots;
+        return index;
+    }
+
+    std::atomic<vector<T> *> current_;
+    std::atomic<unsigned> epoch_{0};
+    mutable reader_slot slots_[ReaderSlots];
+    std::mutex writer_m_;
+};
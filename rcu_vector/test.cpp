@@ -0,0 +1,102 @@
+#define BOOST_TEST_MODULE RcuVectorTests
+
+#include "rcu_vector.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(RcuVectorTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization)
+{
+    rcu_vector<int> v;
+    BOOST_CHECK(v.read().empty());
+
+    rcu_vector<int> filled(vector<int>(3, 7));
+    auto s = filled.read();
+    BOOST_CHECK_EQUAL(s.size(), 3);
+    BOOST_CHECK_EQUAL(s[2], 7);
+}
+
+BOOST_AUTO_TEST_CASE(Update_PublishesNewVersion)
+{
+    rcu_vector<int> v;
+    v.update([](vector<int> &data)
+             { data.push_back(1); data.push_back(2); });
+    v.update([](vector<int> &data)
+             { data[0] = 10; });
+
+    BOOST_CHECK_EQUAL(v.read(
+                          [](const vector<int> &data)
+                          { return data[0] + data[1]; }),
+                      12);
+
+    v.store(vector<int>(5, 1));
+    BOOST_CHECK_EQUAL(v.read().size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(Update_ThrowingLeavesCurrentVersion)
+{
+    rcu_vector<int> v(vector<int>(2, 4));
+    BOOST_CHECK_THROW(v.update([](vector<int> &data)
+                               { data[0] = 0; throw "failed"; }),
+                      const char *);
+    BOOST_CHECK_EQUAL(v.read()[0], 4);
+}
+
+BOOST_AUTO_TEST_CASE(Snapshot_OutlivesUpdateStart)
+{
+    rcu_vector<int> v(vector<int>(4, 1));
+    std::atomic<bool> published{false};
+    std::thread writer;
+
+    {
+        auto s = v.read();
+        writer = std::thread([&]()
+                             {
+            v.store(vector<int>(4, 2));
+            published = true; });
+
+        // the writer cannot reclaim the version this snapshot pins
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        BOOST_CHECK(!published);
+        for (int x : s)
+            BOOST_CHECK_EQUAL(x, 1);
+    }
+    writer.join();
+    BOOST_CHECK(published);
+    BOOST_CHECK_EQUAL(v.read()[0], 2);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentReadersSeeConsistentVersions)
+{
+    // every version holds size copies of one value, a torn read would mix two of them
+    rcu_vector<int, 4> v(vector<int>(64, 0));
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0}; // Boost.Test assertions are not thread safe
+    std::vector<std::thread> readers;
+
+    for (int t = 0; t != 6; ++t)
+        readers.emplace_back([&]()
+                             {
+            while (!stop)
+            {
+                auto s = v.read();
+                for (int x : s)
+                    if (x != s[0])
+                        ++torn;
+            } });
+
+    for (int i = 1; i != 200; ++i)
+        v.store(vector<int>(64, i));
+    stop = true;
+    for (auto &th : readers)
+        th.join();
+
+    BOOST_CHECK_EQUAL(torn, 0);
+    BOOST_CHECK_EQUAL(v.read()[63], 199);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
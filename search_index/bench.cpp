@@ -0,0 +1,67 @@
+#include "./../benchmark.cpp"
+#include "search_index.cpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+/*
+compares plain binary search over the sorted vector with both index layouts
+usage: ./bench [max keys], sizes quadruple from 1M up to max keys (default 64M)
+1B keys needs about 16 GB of memory for the source vector plus the indexes
+*/
+int main(int argc, char **argv) {
+  size_t max_keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64'000'000;
+  const size_t queries = 2'000'000;
+
+  std::printf("%12s %12s %12s %12s %12s %12s   (ns per query)\n", "keys", "binary", "eytzinger",
+              "eytz batch", "s-tree", "s-tree batch");
+
+  for (size_t n = 1'000'000; n <= max_keys; n *= 4) {
+    vector<int> keys(n);
+    std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max() - 1);
+    for (size_t i = 0; i != n; ++i)
+      keys[i] = dist(bench_rng());
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<int> q(queries);
+    for (auto &x : q)
+      x = dist(bench_rng());
+    std::vector<size_t> out(queries);
+
+    eytzinger_index<int> eytzinger(keys);
+    s_tree_index<int> s_tree(keys);
+
+    auto per_query = [&](double seconds) { return seconds / queries * 1e9; };
+
+    double binary = best_of(3, [&] {
+      size_t sum = 0;
+      for (int x : q)
+        sum += std::lower_bound(keys.begin(), keys.end(), x) - keys.begin();
+      do_not_optimize(sum);
+    });
+    double eytz = best_of(3, [&] {
+      size_t sum = 0;
+      for (int x : q)
+        sum += eytzinger.lower_bound(x);
+      do_not_optimize(sum);
+    });
+    double eytz_batch = best_of(3, [&] {
+      eytzinger.lower_bound(q.data(), q.size(), out.data());
+      do_not_optimize(out.back());
+    });
+    double tree = best_of(3, [&] {
+      size_t sum = 0;
+      for (int x : q)
+        sum += s_tree.lower_bound(x);
+      do_not_optimize(sum);
+    });
+    double tree_batch = best_of(3, [&] {
+      s_tree.lower_bound(q.data(), q.size(), out.data());
+      do_not_optimize(out.back());
+    });
+
+    std::printf("%12zu %12.1f %12.1f %12.1f %12.1f %12.1f\n", n, per_query(binary),
+                per_query(eytz), per_query(eytz_batch), per_query(tree), per_query(tree_batch));
+  }
+}
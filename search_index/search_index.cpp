@@ -0,0 +1,255 @@
+#include "./../vector/vector.cpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+immutable search indexes built once from a sorted vector
+
+both layouts answer lower_bound() with the same result as std::lower_bound over the
+source vector: the index of the first key not less than the searched one, or size()
+*/
+
+/* hands out cache line aligned memory so that index nodes never straddle two lines */
+template <typename T> class cache_aligned_allocator {
+public:
+  using value_type = T;
+  static constexpr std::align_val_t alignment{64};
+
+  cache_aligned_allocator() = default;
+  template <typename U> cache_aligned_allocator(const cache_aligned_allocator<U> &) noexcept {}
+
+  T *allocate(size_t n) { return static_cast<T *>(::operator new(n * sizeof(T), alignment)); }
+  void deallocate(T *ptr, size_t n) noexcept { ::operator delete(ptr, n * sizeof(T), alignment); }
+
+  friend bool operator==(const cache_aligned_allocator &, const cache_aligned_allocator &) {
+    return true;
+  }
+  friend bool operator!=(const cache_aligned_allocator &, const cache_aligned_allocator &) {
+    return false;
+  }
+};
+
+template <typename T> void check_sorted(const vector<T> &sorted) {
+  for (size_t i = 1; i < sorted.size(); ++i)
+    if (sorted[i] < sorted[i - 1])
+      throw "search index requires sorted keys";
+}
+
+/*
+keys stored in breadth-first order of the implicit binary search tree: the children of
+node k are 2k and 2k + 1, slot 0 is unused. the 2^d descendants of node k at depth d are
+slots [2^d k, 2^d k + 2^d), so with 2^d = prefetch_stride keys per cache line they share
+one line, which is prefetched on every step: four levels ahead for 4-byte keys, three for
+8-byte keys, none once a key fills a line.
+*/
+template <typename T> class eytzinger_index {
+  // a power of two, or the prefetched slots would not be the descendants of one level
+  static constexpr size_t prefetch_stride = sizeof(T) < 64 ? std::bit_floor(64 / sizeof(T)) : 1;
+  static constexpr size_t batch = 16; // searches advanced in lock-step by the batched API
+
+public:
+  explicit eytzinger_index(const vector<T> &sorted)
+      : keys_(sorted.size() + 1), ranks_(sorted.size() + 1), size_(sorted.size()),
+        height_(std::bit_width(sorted.size())) {
+    if (size_ >= std::numeric_limits<uint32_t>::max())
+      throw "eytzinger_index supports less than 2^32 keys";
+    check_sorted(sorted);
+
+    size_t rank = 0;
+    build(sorted, rank, 1);
+  }
+
+  size_t lower_bound(const T &key) const {
+    const T *keys = keys_.data();
+    size_t k = 1;
+
+    while (k <= size_) {
+      __builtin_prefetch(keys + k * prefetch_stride);
+      k = 2 * k + (keys[k] < key);
+    }
+    return rank_of(k);
+  }
+
+  /* out[i] = lower_bound(keys[i]), overlapping the cache misses of independent searches */
+  void lower_bound(const T *keys, size_t count, size_t *out) const {
+    const T *nodes = keys_.data();
+    size_t k[batch];
+
+    for (size_t first = 0; first < count; first += batch) {
+      size_t n = std::min(batch, count - first);
+      const T *group = keys + first;
+
+      for (size_t i = 0; i != n; ++i)
+        k[i] = 1;
+
+      for (size_t level = 0; level != height_; ++level) {
+        for (size_t i = 0; i != n; ++i) {
+          if (k[i] <= size_) {
+            __builtin_prefetch(nodes + k[i] * prefetch_stride);
+            k[i] = 2 * k[i] + (nodes[k[i]] < group[i]);
+          }
+        }
+      }
+
+      for (size_t i = 0; i != n; ++i)
+        out[first + i] = rank_of(k[i]);
+    }
+  }
+
+  size_t size() const noexcept { return size_; }
+
+private:
+  /* fills slots in in-order, which visits the sorted keys in ascending order */
+  void build(const vector<T> &sorted, size_t &rank, size_t k) {
+    if (k > size_)
+      return;
+
+    build(sorted, rank, 2 * k);
+    keys_[k] = sorted[rank];
+    ranks_[k] = uint32_t(rank);
+    ++rank;
+    build(sorted, rank, 2 * k + 1);
+  }
+
+  /* strips the trailing right turns (and the last left one) to find the answer node */
+  size_t rank_of(size_t k) const {
+    k >>= std::countr_one(k) + 1;
+    return k ? ranks_[k] : size_;
+  }
+
+  vector<T, cache_aligned_allocator<T>> keys_; // keys in breadth-first order
+  vector<uint32_t> ranks_;                     // index in the sorted source for every slot
+  size_t size_;
+  size_t height_; // levels of the implicit tree
+};
+
+/*
+static B+ tree (S+ tree): every node is one cache line of node_keys sorted keys with
+node_keys + 1 children. the leaf layer is the sorted source padded to whole nodes, so the
+rank falls out of the leaf position. internal layers are stored above it, root last.
+a node is searched by counting its keys less than the searched one, which is a handful of
+SIMD compares for 32 bit keys.
+*/
+template <typename T> class s_tree_index {
+  static_assert(std::is_arithmetic_v<T>, "s_tree_index pads nodes with numeric_limits<T>::max()");
+
+  static constexpr size_t node_keys = sizeof(T) < 32 ? 64 / sizeof(T) : 2;
+  static constexpr size_t batch = 16;
+
+public:
+  explicit s_tree_index(const vector<T> &sorted) : size_(sorted.size()) {
+    check_sorted(sorted);
+
+    // the leaf layer holds every key, each layer above one key per child except the last
+    size_t layer_keys = size_;
+    size_t total = 0;
+    do {
+      layer_offsets_.push_back(total);
+      total += blocks(layer_keys) * node_keys;
+      layer_keys = (blocks(layer_keys) + node_keys) / (node_keys + 1) * node_keys;
+    } while (total - layer_offsets_.back() > node_keys);
+
+    nodes_.resize(total, std::numeric_limits<T>::max());
+    std::copy(sorted.begin(), sorted.end(), nodes_.begin());
+
+    // key j of a node is the smallest key in the subtree of its child j + 1
+    for (size_t h = 1; h != layer_offsets_.size(); ++h) {
+      size_t layer_end = h + 1 == layer_offsets_.size() ? total : layer_offsets_[h + 1];
+      for (size_t i = 0; i != layer_end - layer_offsets_[h]; ++i) {
+        size_t leaf = i / node_keys * (node_keys + 1) + i % node_keys + 1;
+        for (size_t l = 1; l != h; ++l)
+          leaf *= node_keys + 1;
+        if (leaf * node_keys < size_)
+          nodes_[layer_offsets_[h] + i] = nodes_[leaf * node_keys];
+      }
+    }
+  }
+
+  size_t lower_bound(const T &key) const {
+    if (size_ == 0)
+      return 0;
+
+    const T *nodes = nodes_.data();
+    size_t k = 0;
+    for (size_t h = layer_offsets_.size() - 1; h != 0; --h)
+      k = k * (node_keys + 1) + node_rank(nodes + layer_offsets_[h] + k * node_keys, key);
+
+    return std::min(k * node_keys + node_rank(nodes + k * node_keys, key), size_);
+  }
+
+  /* out[i] = lower_bound(keys[i]), walking the batch down one layer at a time */
+  void lower_bound(const T *keys, size_t count, size_t *out) const {
+    if (size_ == 0) {
+      std::fill(out, out + count, 0);
+      return;
+    }
+
+    const T *nodes = nodes_.data();
+    size_t k[batch];
+
+    for (size_t first = 0; first < count; first += batch) {
+      size_t n = std::min(batch, count - first);
+      const T *group = keys + first;
+
+      for (size_t i = 0; i != n; ++i)
+        k[i] = 0;
+
+      for (size_t h = layer_offsets_.size() - 1; h != 0; --h) {
+        const T *layer = nodes + layer_offsets_[h];
+        const T *below = nodes + layer_offsets_[h - 1];
+        for (size_t i = 0; i != n; ++i) {
+          k[i] = k[i] * (node_keys + 1) + node_rank(layer + k[i] * node_keys, group[i]);
+          __builtin_prefetch(below + k[i] * node_keys);
+        }
+      }
+
+      for (size_t i = 0; i != n; ++i)
+        out[first + i] = std::min(k[i] * node_keys + node_rank(nodes + k[i] * node_keys, group[i]),
+                                  size_);
+    }
+  }
+
+  size_t size() const noexcept { return size_; }
+
+private:
+  static size_t blocks(size_t keys) noexcept { return (keys + node_keys - 1) / node_keys; }
+
+  /* number of keys in the node that are less than key */
+  static size_t node_rank(const T *node, const T &key) {
+#ifdef __SSE2__
+    if constexpr (std::is_same_v<T, int32_t>) {
+      const __m128i *src = reinterpret_cast<const __m128i *>(node);
+      __m128i x = _mm_set1_epi32(key);
+      __m128i a = _mm_cmpgt_epi32(x, _mm_load_si128(src));
+      __m128i b = _mm_cmpgt_epi32(x, _mm_load_si128(src + 1));
+      __m128i c = _mm_cmpgt_epi32(x, _mm_load_si128(src + 2));
+      __m128i d = _mm_cmpgt_epi32(x, _mm_load_si128(src + 3));
+      __m128i all = _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+      return std::popcount(unsigned(_mm_movemask_epi8(all)));
+    } else if constexpr (std::is_same_v<T, float>) {
+      __m128 x = _mm_set1_ps(key);
+      unsigned mask = 0;
+      for (size_t j = 0; j != node_keys; j += 4)
+        mask |= unsigned(_mm_movemask_ps(_mm_cmplt_ps(_mm_load_ps(node + j), x))) << j;
+      return std::popcount(mask);
+    }
+#endif
+    size_t rank = 0;
+    for (size_t j = 0; j != node_keys; ++j)
+      rank += node[j] < key;
+    return rank;
+  }
+
+  vector<T, cache_aligned_allocator<T>> nodes_; // all layers, leaves first
+  vector<size_t> layer_offsets_;                // index in nodes_ where every layer begins
+  size_t size_;
+};
@@ -0,0 +1,90 @@
+#define BOOST_TEST_MODULE SearchIndexTests
+
+#include "search_index.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+template <typename T> static vector<T> sorted_keys(size_t n, T max_key) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<long long> dist(0, (long long)max_key);
+  std::vector<T> keys(n);
+  for (auto &k : keys)
+    k = T(dist(rng));
+  std::sort(keys.begin(), keys.end());
+
+  vector<T> result(n);
+  std::copy(keys.begin(), keys.end(), result.begin());
+  return result;
+}
+
+// every query in [-1, max_key + 1] must agree with std::lower_bound
+template <typename Index, typename T> static void check_against_std(const vector<T> &keys, T max_key) {
+  Index index(keys);
+  BOOST_REQUIRE_EQUAL(index.size(), keys.size());
+
+  std::vector<T> queries;
+  for (T q = T(-1); q <= max_key + 1; ++q)
+    queries.push_back(q);
+
+  std::vector<size_t> batched(queries.size());
+  index.lower_bound(queries.data(), queries.size(), batched.data());
+
+  for (size_t i = 0; i != queries.size(); ++i) {
+    size_t expected = std::lower_bound(keys.begin(), keys.end(), queries[i]) - keys.begin();
+    BOOST_CHECK_EQUAL(index.lower_bound(queries[i]), expected);
+    BOOST_CHECK_EQUAL(batched[i], expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(SearchIndexTestSuite)
+
+BOOST_AUTO_TEST_CASE(Eytzinger_Empty) {
+  vector<int> keys;
+  eytzinger_index<int> index(keys);
+  BOOST_CHECK_EQUAL(index.size(), 0);
+  BOOST_CHECK_EQUAL(index.lower_bound(5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(STree_Empty) {
+  vector<int> keys;
+  s_tree_index<int> index(keys);
+  BOOST_CHECK_EQUAL(index.size(), 0);
+  BOOST_CHECK_EQUAL(index.lower_bound(5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Unsorted_Throws) {
+  vector<int> keys(3);
+  keys[0] = 3;
+  keys[1] = 1;
+  keys[2] = 2;
+  BOOST_CHECK_THROW(eytzinger_index<int> index(keys), const char *);
+  BOOST_CHECK_THROW(s_tree_index<int> index(keys), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(Eytzinger_MatchesStdLowerBound) {
+  // sizes around powers of two and tree layer boundaries
+  for (size_t n : {1, 2, 3, 7, 8, 15, 16, 17, 100, 255, 256, 1000, 5000})
+    check_against_std<eytzinger_index<int>>(sorted_keys<int>(n, 3000), 3000);
+}
+
+BOOST_AUTO_TEST_CASE(STree_MatchesStdLowerBound) {
+  // sizes around node (16) and layer (16 * 17) boundaries
+  for (size_t n : {1, 2, 15, 16, 17, 271, 272, 273, 4623, 4624, 4625, 10000})
+    check_against_std<s_tree_index<int>>(sorted_keys<int>(n, 20000), 20000);
+}
+
+BOOST_AUTO_TEST_CASE(STree_Duplicates) {
+  check_against_std<s_tree_index<int>>(sorted_keys<int>(3000, 10), 10);
+  check_against_std<eytzinger_index<int>>(sorted_keys<int>(3000, 10), 10);
+}
+
+BOOST_AUTO_TEST_CASE(OtherKeyTypes) {
+  check_against_std<s_tree_index<long long>>(sorted_keys<long long>(2000, 5000), 5000ll);
+  check_against_std<s_tree_index<float>>(sorted_keys<float>(2000, 5000), 5000.0f);
+  check_against_std<eytzinger_index<short>>(sorted_keys<short>(2000, 5000), short(5000));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
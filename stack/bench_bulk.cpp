@@ -0,0 +1,67 @@
+#include "./../benchmark.cpp"
+#include "stack.cpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*
+a parser's token stack: runs of `run` tokens are pushed and popped again, either one
+element at a time (push/pop_value) or batched (push_range/pop_n into an output buffer)
+usage: ./bench_bulk [tokens] [run]
+*/
+
+struct token {
+  uint32_t kind;
+  uint32_t offset;
+  uint64_t value;
+};
+
+template <typename T> static double per_element(const std::vector<T> &tokens, size_t run) {
+  std::vector<T> out(run);
+  stack<T> st(run);
+  return best_of(3, [&] {
+    for (size_t i = 0; i + run <= tokens.size(); i += run) {
+      for (size_t j = 0; j != run; ++j)
+        st.push(tokens[i + j]);
+      for (size_t j = 0; j != run; ++j)
+        out[j] = st.pop_value();
+      do_not_optimize(out.data());
+    }
+  });
+}
+
+template <typename T> static double batched(const std::vector<T> &tokens, size_t run) {
+  std::vector<T> out(run);
+  stack<T> st(run);
+  return best_of(3, [&] {
+    for (size_t i = 0; i + run <= tokens.size(); i += run) {
+      st.push_range(tokens.begin() + i, tokens.begin() + i + run);
+      st.pop_n(run, out.begin());
+      do_not_optimize(out.data());
+    }
+  });
+}
+
+template <typename T> static void row(const char *name, const std::vector<T> &tokens, size_t run) {
+  double n = double(tokens.size() / run * run);
+  std::printf("%-10s %14.2f %14.2f\n", name, per_element(tokens, run) / n * 1e9,
+              batched(tokens, run) / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+  size_t run = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 32;
+
+  std::vector<token> tokens(n);
+  std::vector<std::string> words(n / 4);
+  for (size_t i = 0; i != n; ++i)
+    tokens[i] = token{uint32_t(bench_rng()() % 16), uint32_t(i), bench_rng()()};
+  for (size_t i = 0; i != words.size(); ++i)
+    words[i] = std::string(bench_rng()() % 12, 'w');
+
+  std::printf("runs of %zu, push then pop (ns per element)\n", run);
+  std::printf("%-10s %14s %14s\n", "", "per element", "batched");
+  row("token", tokens, run);
+  row("string", words, run);
+}
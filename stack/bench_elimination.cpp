@@ -0,0 +1,47 @@
+#include "./../benchmark.cpp"
+#include "elimination_stack.cpp"
+#include "lockfree_stack.cpp"
+
+#include <cstdlib>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/*
+balanced push/pop pairs from 1 to 64 threads on one stack: a plain CAS stack serializes
+on its top and flattens once a few threads contend, the elimination stack pairs up pushes
+and pops in its slot array and keeps the top out of the way
+usage: ./bench_elimination [operations per thread]
+*/
+
+template <typename Stack> static double run(int threads, size_t ops) {
+  return best_of(3, [&] {
+    Stack st(size_t(threads) * 2);
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+      workers.emplace_back([&st, ops] {
+        long long sum = 0;
+        for (size_t i = 0; i != ops; ++i) {
+          st.push(int(i));
+          if (std::optional<int> val = st.pop())
+            sum += *val;
+        }
+        do_not_optimize(sum);
+      });
+    for (std::thread &w : workers)
+      w.join();
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+  std::printf("%zu push+pop pairs per thread, %u hardware threads (million pairs per second)\n",
+              ops, std::thread::hardware_concurrency());
+  std::printf("%-8s %14s %14s\n", "threads", "lockfree", "elimination");
+  for (int threads = 1; threads <= 64; threads *= 2) {
+    double pairs = double(ops) * threads;
+    std::printf("%-8d %14.2f %14.2f\n", threads, pairs / run<lockfree_stack<int>>(threads, ops) / 1e6,
+                pairs / run<elimination_stack<int>>(threads, ops) / 1e6);
+  }
+}
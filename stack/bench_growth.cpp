@@ -0,0 +1,49 @@
+#include "./../benchmark.cpp"
+#include "stack.cpp"
+
+#include <cstdlib>
+#include <stack>
+#include <string>
+#include <vector>
+
+/*
+growing from empty to n elements and draining again, the pattern of a DFS that cannot
+pre-size its frame stack; trivially copyable frames relocate with memcpy, strings by move
+usage: ./bench_growth [elements]
+*/
+
+struct frame {
+  uint32_t node;
+  uint32_t next_edge;
+  uint64_t depth;
+};
+
+template <typename Stack, typename Make> static double fill_and_drain(size_t n, Make make) {
+  return best_of(3, [&] {
+    Stack st;
+    for (size_t i = 0; i != n; ++i)
+      st.push(make(i));
+    size_t sum = 0;
+    while (!st.empty()) {
+      sum += sizeof(st.top());
+      st.pop();
+    }
+    do_not_optimize(sum);
+  });
+}
+
+template <typename T, typename Make> static void row(const char *name, size_t n, Make make) {
+  std::printf("%-12s %12.2f %16.2f %16.2f\n", name,
+              fill_and_drain<stack<T>>(n, make) / n * 1e9,
+              fill_and_drain<stack<T, std::ratio<3, 2>>>(n, make) / n * 1e9,
+              fill_and_drain<std::stack<T, std::vector<T>>>(n, make) / n * 1e9);
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+  std::printf("%zu pushes then pops (ns per element)\n", n);
+  std::printf("%-12s %12s %16s %16s\n", "", "stack x2", "stack x1.5", "std::vector");
+  row<frame>("frame", n, [](size_t i) { return frame{uint32_t(i), 0, i}; });
+  row<std::string>("string", n / 4, [](size_t i) { return std::string(i % 16, 'x'); });
+}
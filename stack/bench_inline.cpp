@@ -0,0 +1,76 @@
+#include "./../benchmark.cpp"
+#include "inline_stack.cpp"
+#include "stack.cpp"
+
+#include <cstdlib>
+#include <new>
+
+/*
+short-lived evaluation stacks: each iteration creates a stack, evaluates a random RPN
+expression of up to `depth` operands on it and destroys it. counts heap allocations and
+time against stack, which allocates on the first push of every instance
+usage: ./bench_inline [iterations] [depth]
+*/
+
+static size_t allocations = 0;
+
+void *operator new(size_t bytes) {
+  ++allocations;
+  if (void *p = std::malloc(bytes ? bytes : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+template <typename Stack> static void evaluate(const uint32_t *ops, size_t n, long long &sum) {
+  Stack st;
+  for (size_t i = 0; i != n; ++i) {
+    if (ops[i] == 0 && st.size() >= 2) {
+      long long rhs = st.top();
+      st.pop();
+      st.top() += rhs;
+    } else {
+      st.push(ops[i]);
+    }
+  }
+  sum += st.top();
+}
+
+template <typename Stack>
+static void row(const char *name, const uint32_t *ops, size_t n, size_t iterations) {
+  size_t before = allocations;
+  long long sum = 0;
+  double seconds = time_it([&] {
+    for (size_t it = 0; it != iterations; ++it)
+      evaluate<Stack>(ops + it % 64 * n, n, sum);
+  });
+  do_not_optimize(sum);
+  std::printf("%-22s %12.2f %16.3f\n", name, seconds / iterations * 1e9,
+              double(allocations - before) / iterations);
+}
+
+int main(int argc, char **argv) {
+  size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+  size_t depth = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 6;
+
+  // 64 expressions of depth operands and depth - 1 operators (0) in random valid order
+  size_t n = 2 * depth - 1;
+  uint32_t *ops = static_cast<uint32_t *>(std::malloc(64 * n * sizeof(uint32_t)));
+  for (size_t e = 0; e != 64; ++e) {
+    size_t operands = 0, operators = 0;
+    for (size_t i = 0; i != n; ++i) {
+      bool push = operands < depth && (operands <= operators + 1 || bench_rng()() % 2);
+      ops[e * n + i] = push ? uint32_t(bench_rng()() % 100 + 1) : 0;
+      (push ? operands : operators)++;
+    }
+  }
+
+  std::printf("%zu expressions of %zu operands\n", iterations, depth);
+  std::printf("%-22s %12s %16s\n", "", "ns/expr", "allocs/expr");
+  row<stack<long long>>("stack", ops, n, iterations);
+  row<inline_stack<long long, 8>>("inline_stack<8>", ops, n, iterations);
+  row<inline_stack<long long, 4>>("inline_stack<4>", ops, n, iterations);
+  std::free(ops);
+}
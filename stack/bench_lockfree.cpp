@@ -0,0 +1,75 @@
+#include "./../benchmark.cpp"
+#include "lockfree_stack.cpp"
+#include "stack.cpp"
+
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/*
+contention: every thread pushes and pops the same stack, lockfree_stack against stack
+behind a std::mutex, for 1 to 64 threads
+usage: ./bench_lockfree [operations per thread]
+*/
+
+class mutex_stack {
+public:
+  bool push(int val) {
+    std::lock_guard<std::mutex> lk(m_);
+    st_.push(val);
+    return true;
+  }
+
+  std::optional<int> pop() {
+    std::lock_guard<std::mutex> lk(m_);
+    if (st_.empty())
+      return std::nullopt;
+    int val = st_.top();
+    st_.pop();
+    return val;
+  }
+
+private:
+  stack<int> st_;
+  std::mutex m_;
+};
+
+template <typename Stack> static double run(Stack &st, int threads, size_t ops) {
+  return time_it([&] {
+    std::vector<std::thread> workers;
+    for (int t = 0; t != threads; ++t)
+      workers.emplace_back([&st, ops] {
+        long long sum = 0;
+        for (size_t i = 0; i != ops; ++i) {
+          st.push(int(i));
+          if (std::optional<int> val = st.pop())
+            sum += *val;
+        }
+        do_not_optimize(sum);
+      });
+    for (std::thread &w : workers)
+      w.join();
+  });
+}
+
+int main(int argc, char **argv) {
+  size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+  std::printf("%zu push+pop pairs per thread, %u hardware threads (ns per pair)\n", ops,
+              std::thread::hardware_concurrency());
+  std::printf("%-8s %14s %14s\n", "threads", "lockfree", "mutex");
+  for (int threads = 1; threads <= 64; threads *= 2) {
+    double lockfree = best_of(3, [&] {
+      lockfree_stack<int> st(threads);
+      run(st, threads, ops);
+    });
+    double locked = best_of(3, [&] {
+      mutex_stack st;
+      run(st, threads, ops);
+    });
+    double pairs = double(ops) * threads;
+    std::printf("%-8d %14.2f %14.2f\n", threads, lockfree / pairs * 1e9, locked / pairs * 1e9);
+  }
+}
@@ -0,0 +1,61 @@
+#include "./../benchmark.cpp"
+#include "segmented_stack.cpp"
+#include "stack.cpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+/*
+latency of single pushes and pops while a stack grows to n elements and drains again,
+reported as percentiles: stack pauses for a full relocation whenever it doubles, which
+the average hides but p99.9 and the maximum do not
+usage: ./bench_segmented [elements]
+*/
+
+struct frame {
+  uint64_t words[4];
+};
+
+static uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+template <typename Stack> static void row(const char *name, size_t n) {
+  std::vector<uint32_t> latency(2 * n); // allocated up front, outside the timed region
+  Stack st;
+  frame f{};
+
+  size_t k = 0;
+  double total = time_it([&] {
+    for (size_t i = 0; i != n; ++i) {
+      f.words[0] = i;
+      uint64_t start = now_ns();
+      st.push(f);
+      latency[k++] = uint32_t(now_ns() - start);
+    }
+    for (size_t i = 0; i != n; ++i) {
+      uint64_t start = now_ns();
+      st.pop();
+      latency[k++] = uint32_t(now_ns() - start);
+    }
+  });
+
+  std::sort(latency.begin(), latency.end());
+  auto pct = [&](double p) { return latency[size_t(p / 100 * (latency.size() - 1))]; };
+  std::printf("%-16s %8.1f %8u %8u %8u %10u %10u\n", name, total / latency.size() * 1e9, pct(50),
+              pct(99), pct(99.9), pct(99.99), latency.back());
+}
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+
+  std::printf("%zu pushes then %zu pops of 32-byte frames, ns per operation (incl. clock reads)\n",
+              n, n);
+  std::printf("%-16s %8s %8s %8s %8s %10s %10s\n", "", "mean", "p50", "p99", "p99.9", "p99.99",
+              "max");
+  row<stack<frame>>("stack", n);
+  row<segmented_stack<frame>>("segmented_stack", n);
+}
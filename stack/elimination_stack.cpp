@@ -0,0 +1,177 @@
+#pragma once
+
+#include "lockfree_stack.cpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+/*
+lock-free stack with an elimination array in front of the shared top
+
+a push or pop whose CAS on the top fails backs off into a random slot of a small array
+instead of retrying at once. a pusher parks its node there for a few spins; a popper that
+finds a parked node takes it with a CAS on the slot and never touches the top. a push and a
+pop that cancel out this way are linearized at the moment of the exchange.
+
+the part of the array in use adapts to contention: it widens when a visited slot is
+already occupied by another pusher and narrows when a parked node times out unmatched, so
+under light load backoff stays on the first few slots where pops can find it.
+
+values live in the same bounded node_pool as lockfree_stack, so push() returns false once
+the pool is exhausted.
+*/
+template <typename T, uint32_t Slots = 16> class elimination_stack {
+  static_assert(Slots > 0, "at least one elimination slot");
+
+public:
+  explicit elimination_stack(size_t capacity, memory_tag tag = memory_tag())
+      : pool_(capacity, tag), items_(pool_.links()), range_(1) {
+    for (slot &s : slots_)
+      s.state_.store(empty_slot, std::memory_order_relaxed);
+  }
+
+  elimination_stack(const elimination_stack &) = delete;
+  elimination_stack &operator=(const elimination_stack &) = delete;
+
+  ~elimination_stack() {
+    for (uint32_t i = items_.pop_all(); i != npos;
+         i = pool_.link(i).load(std::memory_order_relaxed))
+      pool_.slot(i)->~T();
+  }
+
+  // returns false when the pool is exhausted
+  bool push(const T &val) {
+    uint32_t node = pool_.allocate();
+    if (node == npos)
+      return false;
+    try {
+      new (pool_.slot(node)) T(val);
+    } catch (...) {
+      pool_.release(node);
+      throw;
+    }
+
+    uint64_t head = items_.load();
+    while (!items_.try_push_chain(head, node, node)) {
+      if (eliminate_push(node))
+        return true;
+      head = items_.load();
+    }
+    return true;
+  }
+
+  std::optional<T> pop() {
+    uint64_t head = items_.load();
+    uint32_t node;
+    while (!items_.try_pop(head, node)) {
+      if ((node = eliminate_pop()) != npos)
+        break;
+      head = items_.load();
+    }
+    if (node == npos)
+      return std::nullopt;
+
+    std::optional<T> result;
+    try {
+      result.emplace(std::move(*pool_.slot(node)));
+    } catch (...) {
+      pool_.slot(node)->~T();
+      pool_.release(node);
+      throw;
+    }
+    pool_.slot(node)->~T();
+    pool_.release(node);
+    return result;
+  }
+
+  bool pop(T &out) {
+    std::optional<T> val = pop();
+    if (!val)
+      return false;
+    out = std::move(*val);
+    return true;
+  }
+
+  // a snapshot, other threads may change it right after
+  bool empty() const { return items_.empty(); }
+  size_t capacity() const { return pool_.capacity(); }
+
+private:
+  static constexpr uint32_t npos = index_list::npos;
+  // slot states besides the index of a parked node
+  static constexpr uint32_t empty_slot = npos;
+  static constexpr uint32_t taken_slot = npos - 1;
+  // how many times a pusher re-checks its slot before taking the node back
+  static constexpr int park_spins = 64;
+
+  struct alignas(64) slot {
+    std::atomic<uint32_t> state_;
+  };
+
+  /* parks node in a slot until a popper takes it; false if nobody did and node is ours again */
+  bool eliminate_push(uint32_t node) {
+    uint32_t range = range_.load(std::memory_order_relaxed);
+    slot &s = slots_[random_below(range)];
+
+    uint32_t expected = empty_slot;
+    if (!s.state_.compare_exchange_strong(expected, node, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+      // another pusher is parked here, the array is too narrow
+      if (range < Slots)
+        range_.compare_exchange_weak(range, range + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    for (int spin = 0; spin != park_spins; ++spin) {
+      if (s.state_.load(std::memory_order_relaxed) == taken_slot) {
+        s.state_.store(empty_slot, std::memory_order_relaxed);
+        return true;
+      }
+      std::this_thread::yield();
+    }
+
+    expected = node;
+    if (s.state_.compare_exchange_strong(expected, empty_slot, std::memory_order_relaxed)) {
+      // nobody came, the array is wider than the traffic
+      if (range > 1)
+        range_.compare_exchange_weak(range, range - 1, std::memory_order_relaxed);
+      return false;
+    }
+    // a popper took the node between the last check and the CAS
+    s.state_.store(empty_slot, std::memory_order_relaxed);
+    return true;
+  }
+
+  /* takes a node parked in a random slot, or returns npos */
+  uint32_t eliminate_pop() {
+    slot &s = slots_[random_below(range_.load(std::memory_order_relaxed))];
+    uint32_t node = s.state_.load(std::memory_order_relaxed);
+    if (node == empty_slot || node == taken_slot)
+      return npos;
+    // acquire pairs with the pusher's release, which published the value in node
+    if (!s.state_.compare_exchange_strong(node, taken_slot, std::memory_order_acquire,
+                                          std::memory_order_relaxed))
+      return npos;
+    return node;
+  }
+
+  static uint32_t random_below(uint32_t n) {
+    // xorshift, one state per thread shared by all stacks
+    thread_local uint32_t state =
+        uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return uint32_t((uint64_t(state) * n) >> 32);
+  }
+
+  node_pool<T> pool_;
+  alignas(64) index_list items_;
+  alignas(64) std::atomic<uint32_t> range_; // slots in use, in [1, Slots]
+  slot slots_[Slots];
+};
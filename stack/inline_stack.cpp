@@ -0,0 +1,248 @@
+#pragma once
+
+#include "stack_base.cpp"
+
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+/*
+LIFO stack keeping its first N elements inside the object
+
+a stack that never holds more than N elements never allocates. the first push past N
+spills every element to heap storage owned by a stack_base, after which it grows like
+stack: to 1 + capacity * Growth. start_/end_/capacity_ point into whichever storage is in
+use, so push/pop/top are the same pointer bumps in both modes.
+
+moving a stack that lives inline moves its elements one by one, so unlike stack the move
+operations are only noexcept when T's move constructor is.
+*/
+template <typename T, size_t N, typename Growth = std::ratio<2>> class inline_stack {
+  static_assert(N > 0, "use stack for a stack without inline storage");
+  static_assert(Growth::num > Growth::den, "the growth factor must be greater than 1");
+
+  static constexpr bool nothrow_move = std::is_nothrow_move_constructible_v<T>;
+
+public:
+  explicit inline_stack(memory_tag tag = memory_tag())
+      : start_(buffer()), end_(start_), capacity_(start_ + N), spill_(0, tag) {}
+
+  // copy constructor
+  inline_stack(const inline_stack &oth) : inline_stack(oth.spill_.tag_) {
+    if (oth.size() > N)
+      adopt(stack_base<T>(oth.size(), spill_.tag_));
+    spill_.uninitialized_copy(oth.start_, oth.end_, start_);
+    end_ = start_ + oth.size();
+  }
+
+  // copy assignment
+  inline_stack &operator=(const inline_stack &oth) {
+    // copy-and-swap idiom
+    inline_stack tmp(oth); // copy
+    swap(*this, tmp);      // swap
+    return *this;
+  }
+
+  // move constructor
+  inline_stack(inline_stack &&oth) noexcept(nothrow_move) : inline_stack(oth.spill_.tag_) {
+    take(oth);
+  }
+
+  // move assignment
+  inline_stack &operator=(inline_stack &&oth) noexcept(nothrow_move) {
+    if (this != &oth) {
+      clear();
+      release();
+      take(oth);
+    }
+    return *this;
+  }
+
+  // destructor
+  ~inline_stack() { clear(); }
+
+  /* heap storage is swapped by pointer, inline elements have to be moved */
+  friend void swap(inline_stack &lhs, inline_stack &rhs) noexcept(nothrow_move) {
+    if (!lhs.is_inline() && !rhs.is_inline()) {
+      using std::swap;
+      swap(lhs.start_, rhs.start_);
+      swap(lhs.end_, rhs.end_);
+      swap(lhs.capacity_, rhs.capacity_);
+      swap(lhs.spill_, rhs.spill_);
+      return;
+    }
+    inline_stack tmp(std::move(lhs));
+    lhs = std::move(rhs);
+    rhs = std::move(tmp);
+  }
+
+  void push(const T &val) { emplace(val); }
+  void push(T &&val) { emplace(std::move(val)); }
+
+  /* constructs the new top in place from args, which may refer to elements of this stack */
+  template <typename... Args> T &emplace(Args &&...args) {
+    if (full())
+      return grow_and_emplace(std::forward<Args>(args)...);
+
+    spill_.construct(end_, std::forward<Args>(args)...);
+    return *end_++;
+  }
+
+  void pop() {
+    if (empty())
+      throw "empty stack";
+    spill_.destroy(end_ - 1);
+    --end_;
+  }
+
+  /* moves the top out and pops it, a throwing move leaves the stack unchanged */
+  T pop_value() {
+    if (empty())
+      throw "empty stack";
+    T val(std::move(*(end_ - 1)));
+    spill_.destroy(end_ - 1);
+    --end_;
+    return val;
+  }
+
+  T &top() {
+    if (empty())
+      throw "empty stack";
+
+    return *(end_ - 1);
+  }
+
+  const T &top() const {
+    if (empty())
+      throw "empty stack";
+
+    return *(end_ - 1);
+  }
+
+  /* reserve() provides strong exception safety guarantee */
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity())
+      reallocate(new_capacity);
+  }
+
+  /* releases unused heap capacity, moving the elements back inline when they fit */
+  void shrink_to_fit() {
+    if (is_inline() || size() == capacity())
+      return;
+    if (size() > N) {
+      reallocate(size());
+      return;
+    }
+
+    spill_.uninitialized_relocate(start_, end_, buffer());
+    size_t n = size();
+    spill_.destroy_range(start_, end_);
+    release();
+    end_ = start_ + n;
+  }
+
+  friend bool operator==(const inline_stack &lhs, const inline_stack &rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    for (size_t i = 0; i != lhs.size(); ++i)
+      if (!(lhs.start_[i] == rhs.start_[i]))
+        return false;
+    return true;
+  }
+
+  friend bool operator!=(const inline_stack &lhs, const inline_stack &rhs) { return !(lhs == rhs); }
+
+  size_t count() const noexcept { return size(); }
+  size_t size() const noexcept { return end_ - start_; }
+  size_t capacity() const noexcept { return capacity_ - start_; }
+
+  bool empty() const noexcept { return start_ == end_; }
+  bool full() const noexcept { return end_ == capacity_; }
+
+  /* whether the elements live inside the object */
+  bool is_inline() const noexcept { return spill_.start_ == nullptr; }
+
+private:
+  T *buffer() noexcept { return reinterpret_cast<T *>(buffer_); }
+
+  void clear() noexcept {
+    spill_.destroy_range(start_, end_);
+    end_ = start_;
+  }
+
+  /* frees the heap storage of an empty stack and points it back at the buffer */
+  void release() noexcept {
+    spill_ = stack_base<T>(0, spill_.tag_);
+    start_ = end_ = buffer();
+    capacity_ = start_ + N;
+  }
+
+  /* makes base the storage of an empty stack */
+  void adopt(stack_base<T> &&base) noexcept {
+    swap(spill_, base);
+    start_ = end_ = spill_.start_;
+    capacity_ = spill_.capacity_;
+  }
+
+  /* moves the contents of oth into this empty inline stack and leaves oth empty */
+  void take(inline_stack &oth) noexcept(nothrow_move) {
+    spill_.tag_ = oth.spill_.tag_;
+    if (oth.is_inline()) {
+      if constexpr (std::is_trivially_copyable_v<T>)
+        spill_.uninitialized_relocate(oth.start_, oth.end_, start_);
+      else
+        spill_.uninitialized_move(oth.start_, oth.end_, start_);
+      end_ = start_ + oth.size();
+      oth.clear();
+      return;
+    }
+
+    using std::swap;
+    swap(spill_, oth.spill_);
+    start_ = oth.start_;
+    end_ = oth.end_;
+    capacity_ = oth.capacity_;
+    oth.start_ = oth.end_ = oth.buffer();
+    oth.capacity_ = oth.start_ + N;
+  }
+
+  size_t next_capacity() const noexcept { return 1 + capacity() * Growth::num / Growth::den; }
+
+  /* moves the elements to new heap storage, leaving this stack untouched on an exception */
+  void reallocate(size_t new_capacity) {
+    stack_base<T> new_base(new_capacity, spill_.tag_);
+    new_base.tag_.on_reallocate();
+    new_base.uninitialized_relocate(start_, end_, new_base.start_);
+    install(std::move(new_base), size());
+  }
+
+  /* args may refer to elements of this stack, so the new top is built before they are relocated */
+  template <typename... Args> T &grow_and_emplace(Args &&...args) {
+    stack_base<T> new_base(next_capacity(), spill_.tag_);
+    new_base.tag_.on_reallocate();
+    new_base.construct(new_base.start_ + size(), std::forward<Args>(args)...);
+    try {
+      new_base.uninitialized_relocate(start_, end_, new_base.start_);
+    } catch (...) {
+      new_base.destroy(new_base.start_ + size());
+      throw;
+    }
+    install(std::move(new_base), size() + 1);
+    return *(end_ - 1);
+  }
+
+  /* swaps in storage already holding n relocated elements, destroying the old ones */
+  void install(stack_base<T> &&new_base, size_t n) noexcept {
+    spill_.destroy_range(start_, end_);
+    swap(spill_, new_base);
+    start_ = spill_.start_;
+    end_ = start_ + n;
+    capacity_ = spill_.capacity_;
+  }
+
+  T *start_;    // first element, in buffer_ or in spill_
+  T *end_;      // where the next element will be inserted
+  T *capacity_; // end of the storage in use
+  stack_base<T> spill_; // heap storage once the stack outgrew N, empty while inline
+  alignas(T) unsigned char buffer_[N * sizeof(T)];
+};
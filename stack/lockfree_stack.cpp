@@ -0,0 +1,283 @@
+#pragma once
+
+#include "./../memory_accounting/memory_accounting.cpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+/*
+Treiber stack of node indices
+
+nodes live in an array owned by the caller and are linked through links[index]. the head
+packs the top index with a tag that every successful CAS increments, so a head that was
+popped and pushed back between a load and the CAS (the ABA problem) no longer compares
+equal. nodes are never freed while the list exists, so reading links[] of a node another
+thread just took is harmless: the CAS that would act on it fails.
+*/
+class index_list {
+public:
+  static constexpr uint32_t npos = UINT32_MAX;
+
+  explicit index_list(std::atomic<uint32_t> *links) : head_(pack(0, npos)), links_(links) {}
+
+  index_list(const index_list &) = delete;
+  index_list &operator=(const index_list &) = delete;
+
+  // pushes the chain first -> ... -> last, already linked through links
+  void push_chain(uint32_t first, uint32_t last) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    while (!try_push_chain(head, first, last))
+      ;
+  }
+
+  // one CAS attempt, head is refreshed on failure
+  bool try_push_chain(uint64_t &head, uint32_t first, uint32_t last) {
+    links_[last].store(index(head), std::memory_order_relaxed);
+    return head_.compare_exchange_weak(head, pack(tag(head) + 1, first), std::memory_order_release,
+                                       std::memory_order_relaxed);
+  }
+
+  // returns npos when empty
+  uint32_t pop() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint32_t result;
+    while (!try_pop(head, result))
+      ;
+    return result;
+  }
+
+  // one CAS attempt, true when it succeeded or the list was empty (result is then npos)
+  bool try_pop(uint64_t &head, uint32_t &result) {
+    result = index(head);
+    if (result == npos)
+      return true;
+    uint32_t next = links_[result].load(std::memory_order_relaxed);
+    return head_.compare_exchange_weak(head, pack(tag(head) + 1, next), std::memory_order_acquire,
+                                       std::memory_order_acquire);
+  }
+
+  // detaches the whole list, returns its first index or npos
+  uint32_t pop_all() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (index(head) != npos &&
+           !head_.compare_exchange_weak(head, pack(tag(head) + 1, npos), std::memory_order_acquire,
+                                        std::memory_order_acquire))
+      ;
+    return index(head);
+  }
+
+  uint64_t load() const { return head_.load(std::memory_order_acquire); }
+  bool empty() const { return index(load()) == npos; }
+
+  static uint32_t index(uint64_t head) { return uint32_t(head); }
+  static uint32_t tag(uint64_t head) { return uint32_t(head >> 32); }
+  static uint64_t pack(uint32_t tag, uint32_t index) { return (uint64_t(tag) << 32) | index; }
+
+private:
+  std::atomic<uint64_t> head_;
+  std::atomic<uint32_t> *links_;
+};
+
+/*
+fixed pool of uninitialized T slots, handed out by index through a lock-free free list
+*/
+template <typename T> class node_pool {
+public:
+  static constexpr uint32_t npos = index_list::npos;
+
+  explicit node_pool(size_t capacity, memory_tag tag = memory_tag())
+      : capacity_(checked_capacity(capacity)), links_(new std::atomic<uint32_t>[capacity]),
+        slots_(static_cast<T *>(::operator new(capacity * sizeof(T)))), free_(links_.get()),
+        tag_(tag) {
+    tag_.on_allocate(capacity * (sizeof(T) + sizeof(std::atomic<uint32_t>)));
+
+    for (size_t i = 0; i + 1 < capacity; ++i)
+      links_[i].store(uint32_t(i + 1), std::memory_order_relaxed);
+    if (capacity)
+      free_.push_chain(0, uint32_t(capacity - 1));
+  }
+
+  node_pool(const node_pool &) = delete;
+  node_pool &operator=(const node_pool &) = delete;
+
+  // the owner destroys every live value before the pool goes away
+  ~node_pool() {
+    tag_.on_deallocate(capacity_ * (sizeof(T) + sizeof(std::atomic<uint32_t>)));
+    ::operator delete(slots_, capacity_ * sizeof(T));
+  }
+
+  // returns npos when every slot is in use
+  uint32_t allocate() { return free_.pop(); }
+  void release(uint32_t index) { free_.push_chain(index, index); }
+  void release_chain(uint32_t first, uint32_t last) { free_.push_chain(first, last); }
+
+  T *slot(uint32_t index) const { return slots_ + index; }
+  std::atomic<uint32_t> *links() const { return links_.get(); }
+  std::atomic<uint32_t> &link(uint32_t index) const { return links_[index]; }
+  size_t capacity() const { return capacity_; }
+
+private:
+  // indices are 32-bit and npos is reserved
+  static size_t checked_capacity(size_t capacity) {
+    if (capacity >= npos)
+      throw "pool capacity out of range";
+    return capacity;
+  }
+
+  size_t capacity_;
+  std::unique_ptr<std::atomic<uint32_t>[]> links_;
+  T *slots_;
+  alignas(64) index_list free_;
+  [[no_unique_address]] memory_tag tag_;
+};
+
+/*
+lock-free LIFO stack with bounded memory
+
+values live in a node_pool sized at construction, push() returns false instead of
+allocating once the pool is exhausted. every operation is one successful CAS on the
+stack head plus one on the pool's free list; push_list() links a whole batch privately and
+publishes it with a single CAS, pop_all() detaches the whole stack with one.
+*/
+template <typename T> class lockfree_stack {
+public:
+  explicit lockfree_stack(size_t capacity, memory_tag tag = memory_tag())
+      : pool_(capacity, tag), items_(pool_.links()) {}
+
+  lockfree_stack(const lockfree_stack &) = delete;
+  lockfree_stack &operator=(const lockfree_stack &) = delete;
+
+  ~lockfree_stack() {
+    for (uint32_t i = items_.pop_all(); i != npos;
+         i = pool_.link(i).load(std::memory_order_relaxed))
+      pool_.slot(i)->~T();
+  }
+
+  // returns false when the pool is exhausted
+  bool push(const T &val) {
+    uint32_t node = pool_.allocate();
+    if (node == npos)
+      return false;
+    construct(node, val);
+    items_.push_chain(node, node);
+    return true;
+  }
+
+  // pushes [first, last) in order, so *first ends up deepest; stops early when the pool runs
+  // out and returns the number of values pushed
+  template <typename InputIt> size_t push_list(InputIt first, InputIt last) {
+    uint32_t top = npos, bottom = npos;
+    size_t count = 0;
+
+    for (; first != last; ++first, ++count) {
+      uint32_t node = pool_.allocate();
+      if (node == npos)
+        break;
+      try {
+        construct(node, *first);
+      } catch (...) {
+        // construct() returned the node, the values built so far are still pushed
+        if (top != npos)
+          items_.push_chain(top, bottom);
+        throw;
+      }
+      pool_.link(node).store(top, std::memory_order_relaxed);
+      if (top == npos)
+        bottom = node;
+      top = node;
+    }
+
+    if (top != npos)
+      items_.push_chain(top, bottom);
+    return count;
+  }
+
+  bool pop(T &out) {
+    uint32_t node = items_.pop();
+    if (node == npos)
+      return false;
+    try {
+      out = std::move(*pool_.slot(node));
+    } catch (...) {
+      destroy(node);
+      throw;
+    }
+    destroy(node);
+    return true;
+  }
+
+  std::optional<T> pop() {
+    uint32_t node = items_.pop();
+    if (node == npos)
+      return std::nullopt;
+    std::optional<T> result;
+    try {
+      result.emplace(std::move(*pool_.slot(node)));
+    } catch (...) {
+      destroy(node);
+      throw;
+    }
+    destroy(node);
+    return result;
+  }
+
+  // detaches every value at once and moves them to out, top first; returns how many
+  template <typename OutputIt> size_t pop_all(OutputIt out) {
+    uint32_t first = items_.pop_all();
+    if (first == npos)
+      return 0;
+
+    size_t count = 0;
+    uint32_t i = first, last = first;
+    try {
+      for (; i != npos; i = pool_.link(i).load(std::memory_order_relaxed), ++count) {
+        *out++ = std::move(*pool_.slot(i));
+        pool_.slot(i)->~T();
+        last = i;
+      }
+    } catch (...) {
+      // the values not reached yet go back on the stack, first..i goes back to the pool
+      uint32_t next = pool_.link(i).load(std::memory_order_relaxed);
+      pool_.slot(i)->~T();
+      if (next != npos) {
+        uint32_t tail = next;
+        while (pool_.link(tail).load(std::memory_order_relaxed) != npos)
+          tail = pool_.link(tail).load(std::memory_order_relaxed);
+        items_.push_chain(next, tail);
+      }
+      pool_.release_chain(first, i);
+      throw;
+    }
+    // the detached chain is still linked, so it returns to the pool with one CAS
+    pool_.release_chain(first, last);
+    return count;
+  }
+
+  // a snapshot, other threads may change it right after
+  bool empty() const { return items_.empty(); }
+  size_t capacity() const { return pool_.capacity(); }
+
+private:
+  static constexpr uint32_t npos = index_list::npos;
+
+  void construct(uint32_t node, const T &val) {
+    try {
+      new (pool_.slot(node)) T(val);
+    } catch (...) {
+      pool_.release(node);
+      throw;
+    }
+  }
+
+  void destroy(uint32_t node) {
+    pool_.slot(node)->~T();
+    pool_.release(node);
+  }
+
+  node_pool<T> pool_;
+  alignas(64) index_list items_;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "stack_base.cpp"
+
+#include <utility>
+
+/*
+LIFO stack over a chain of fixed-size stack_base segments
+
+elements are never relocated: a push that finds the top segment full moves on to the next
+segment, a pop that empties a segment moves back to the previous one. every push and pop
+therefore constructs or destroys one element and allocates or frees at most one segment,
+O(1) in the worst case instead of amortized, with no reallocation pause.
+
+one emptied segment is kept linked above the top, so push/pop alternating across a
+segment boundary reuse it instead of allocating and freeing a segment each time. a second
+emptied segment is freed, so the cache never holds more than one.
+
+segments are about 4 KiB by default, at least 16 elements.
+*/
+template <typename T, size_t SegmentSize = (sizeof(T) * 16 > 4096 ? 16 : 4096 / sizeof(T))>
+class segmented_stack {
+  static_assert(SegmentSize > 0, "a segment needs room for at least one element");
+
+  struct segment {
+    explicit segment(memory_tag tag) : items_(SegmentSize, tag) {}
+
+    stack_base<T> items_;
+    segment *prev_ = nullptr;
+    segment *next_ = nullptr;
+  };
+
+public:
+  static constexpr size_t segment_size = SegmentSize;
+
+  explicit segmented_stack(memory_tag tag = memory_tag())
+      : bottom_(nullptr), top_(nullptr), size_(0), tag_(tag) {}
+
+  // copy constructor, the destructor cleans up if a copy throws (the delegated constructor has run)
+  segmented_stack(const segmented_stack &oth) : segmented_stack(oth.tag_) {
+    for (segment *seg = oth.bottom_; seg != nullptr && !seg->items_.empty(); seg = seg->next_)
+      for (T *p = seg->items_.start_; p != seg->items_.end_; ++p)
+        emplace(*p);
+  }
+
+  // copy assignment
+  segmented_stack &operator=(const segmented_stack &oth) {
+    // copy-and-swap idiom
+    segmented_stack tmp(oth); // copy
+    swap(*this, tmp);         // swap
+    return *this;
+  }
+
+  // move constructor
+  segmented_stack(segmented_stack &&oth) noexcept : segmented_stack(oth.tag_) { swap(*this, oth); }
+
+  // move assignment
+  segmented_stack &operator=(segmented_stack &&oth) noexcept {
+    // move-and-swap idiom
+    segmented_stack tmp(std::move(oth)); // move
+    swap(*this, tmp);                    // swap
+    return *this;
+  }
+
+  // destructor
+  ~segmented_stack() { release(); }
+
+  friend void swap(segmented_stack &lhs, segmented_stack &rhs) noexcept {
+    using std::swap;
+    swap(lhs.bottom_, rhs.bottom_);
+    swap(lhs.top_, rhs.top_);
+    swap(lhs.size_, rhs.size_);
+    swap(lhs.tag_, rhs.tag_);
+  }
+
+  void push(const T &val) { emplace(val); }
+  void push(T &&val) { emplace(std::move(val)); }
+
+  /* constructs the new top in place; elements never move, so args may refer to one */
+  template <typename... Args> T &emplace(Args &&...args) {
+    segment *seg = top_;
+    if (seg == nullptr) {
+      seg = bottom_ = top_ = new segment(tag_);
+    } else if (seg->items_.full()) {
+      if (seg->next_ == nullptr) {
+        seg->next_ = new segment(tag_);
+        seg->next_->prev_ = seg;
+      }
+      seg = seg->next_;
+    }
+
+    // top_ only moves once the element exists, a throwing constructor leaves the stack as is
+    seg->items_.construct(seg->items_.end_, std::forward<Args>(args)...);
+    ++seg->items_.end_;
+    top_ = seg;
+    ++size_;
+    return *(seg->items_.end_ - 1);
+  }
+
+  void pop() {
+    if (empty())
+      throw "empty stack";
+    stack_base<T> &items = top_->items_;
+    items.destroy(items.end_ - 1);
+    --items.end_;
+    --size_;
+
+    if (items.empty() && top_->prev_ != nullptr) {
+      // the emptied segment becomes the cached one, a segment cached before it is freed
+      delete std::exchange(top_->next_, nullptr);
+      top_ = top_->prev_;
+    }
+  }
+
+  /* moves the top out and pops it, a throwing move leaves the stack unchanged */
+  T pop_value() {
+    T val(std::move(top()));
+    pop();
+    return val;
+  }
+
+  T &top() {
+    if (empty())
+      throw "empty stack";
+
+    return *(top_->items_.end_ - 1);
+  }
+
+  const T &top() const {
+    if (empty())
+      throw "empty stack";
+
+    return *(top_->items_.end_ - 1);
+  }
+
+  /* every segment below the top is full, so the stacks compare segment by segment */
+  friend bool operator==(const segmented_stack &lhs, const segmented_stack &rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    const segment *l = lhs.bottom_, *r = rhs.bottom_;
+    for (size_t left = lhs.size(); left != 0; l = l->next_, r = r->next_) {
+      for (size_t i = 0; i != l->items_.size(); ++i)
+        if (!(l->items_.start_[i] == r->items_.start_[i]))
+          return false;
+      left -= l->items_.size();
+    }
+    return true;
+  }
+
+  friend bool operator!=(const segmented_stack &lhs, const segmented_stack &rhs) {
+    return !(lhs == rhs);
+  }
+
+  size_t count() const noexcept { return size_; }
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return 0 == size_; }
+
+  /* segments allocated, including the cached one */
+  size_t segments() const noexcept {
+    size_t n = 0;
+    for (const segment *seg = bottom_; seg != nullptr; seg = seg->next_)
+      ++n;
+    return n;
+  }
+
+private:
+  /* destroys every element and frees every segment */
+  void release() noexcept {
+    for (segment *seg = bottom_; seg != nullptr;) {
+      seg->items_.destroy_range(seg->items_.start_, seg->items_.end_);
+      delete std::exchange(seg, seg->next_);
+    }
+    bottom_ = top_ = nullptr;
+    size_ = 0;
+  }
+
+  segment *bottom_; // first segment, or null before the first push
+  segment *top_;    // segment holding the top element, bottom_ when empty
+  size_t size_;
+
+  [[no_unique_address]] memory_tag tag_;
+};
@@ -1,11 +1,26 @@
+#pragma once
+
 #include "stack_base.cpp"
 
-template <typename T> class stack {
+#include <iterator>
+#include <ratio>
+#include <type_traits>
+
+/*
+LIFO stack over stack_base storage
+
+a full stack grows to 1 + capacity * Growth (0, 1, 3, 7, ... for the default factor of 2),
+so push is amortized O(1). elements are relocated with memcpy when trivially copyable and
+with move_if_noexcept semantics otherwise, so a throwing copy leaves the stack unchanged.
+*/
+template <typename T, typename Growth = std::ratio<2>> class stack {
+  static_assert(Growth::num > Growth::den, "the growth factor must be greater than 1");
+
 public:
-  stack(size_t capacity = 16) : stack_base_(capacity) {}
+  stack(size_t capacity = 0, memory_tag tag = memory_tag()) : stack_base_(capacity, tag) {}
 
   // copy constructor
-  stack(const stack &oth) : stack_base_(oth.stack_base_.capacity()) {
+  stack(const stack &oth) : stack_base_(oth.stack_base_.capacity(), oth.stack_base_.tag_) {
     stack_base_.uninitialized_copy(oth.stack_base_.start_, oth.stack_base_.end_,
                                    stack_base_.start_);
     stack_base_.end_ = stack_base_.start_ + oth.stack_base_.size();
@@ -33,12 +48,38 @@ public:
   // destructor
   ~stack() { stack_base_.destroy_range(stack_base_.start_, stack_base_.end_); }
 
-  void push(const T &val) {
+  void push(const T &val) { emplace(val); }
+  void push(T &&val) { emplace(std::move(val)); }
+
+  /* constructs the new top in place from args, which may refer to elements of this stack */
+  template <typename... Args> T &emplace(Args &&...args) {
     if (full())
-      throw "empty stack";
+      return grow_and_emplace(std::forward<Args>(args)...);
+
+    stack_base_.construct(stack_base_.end_, std::forward<Args>(args)...);
+    return *stack_base_.end_++;
+  }
 
-    stack_base_.construct(stack_base_.end_, val);
-    ++stack_base_.end_;
+  /*
+  pushes [first, last) in order, so *(last - 1) ends up on top. a forward range is sized
+  once and copied with stack_base::uninitialized_copy (a memcpy for trivially copyable T);
+  the range may come from this stack. strong exception safety guarantee, except for single
+  pass iterators which push one element at a time
+  */
+  template <typename InputIt> void push_range(InputIt first, InputIt last) {
+    if constexpr (!std::is_base_of_v<std::forward_iterator_tag,
+                                     typename std::iterator_traits<InputIt>::iterator_category>) {
+      for (; first != last; ++first)
+        emplace(*first);
+    } else {
+      size_t n = std::distance(first, last);
+      if (n > capacity() - size()) {
+        grow_and_push_range(first, last, n);
+        return;
+      }
+      stack_base_.uninitialized_copy(first, last, stack_base_.end_);
+      stack_base_.end_ += n;
+    }
   }
 
   void pop() {
@@ -48,6 +89,38 @@ public:
     --stack_base_.end_;
   }
 
+  /* pops the top n elements */
+  void pop_n(size_t n) {
+    check_size(n);
+    stack_base_.destroy_range(stack_base_.end_ - n, stack_base_.end_);
+    stack_base_.end_ -= n;
+  }
+
+  /*
+  moves the top n elements to out, top first as if popped one by one, then pops them.
+  if a move throws nothing is popped, the elements already moved are left moved-from
+  */
+  template <typename OutputIt> OutputIt pop_n(size_t n, OutputIt out) {
+    check_size(n);
+    for (T *p = stack_base_.end_; p != stack_base_.end_ - n;)
+      *out++ = std::move(*--p);
+    pop_n(n);
+    return out;
+  }
+
+  /*
+  moves the top out and pops it. strong exception safety guarantee: the element is only
+  destroyed once it has been moved out, so a throwing move leaves the stack unchanged
+  */
+  T pop_value() {
+    if (empty())
+      throw "empty stack";
+    T val(std::move(*(stack_base_.end_ - 1)));
+    stack_base_.destroy(stack_base_.end_ - 1);
+    --stack_base_.end_;
+    return val;
+  }
+
   T &top() {
     if (empty())
       throw "empty stack";
@@ -62,11 +135,34 @@ public:
     return *(stack_base_.end_ - 1);
   }
 
-  friend void swap(stack<T> &lhs, stack<T> &rhs) {
+  /* reserve() provides strong exception safety guarantee */
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity())
+      reallocate(new_capacity);
+  }
+
+  /* releases unused capacity, an empty stack frees its storage */
+  void shrink_to_fit() {
+    if (size() != capacity())
+      reallocate(size());
+  }
+
+  friend void swap(stack &lhs, stack &rhs) noexcept {
     using std::swap;
     swap(lhs.stack_base_, rhs.stack_base_);
   }
 
+  friend bool operator==(const stack &lhs, const stack &rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    for (size_t i = 0; i != lhs.size(); ++i)
+      if (!(lhs.stack_base_.start_[i] == rhs.stack_base_.start_[i]))
+        return false;
+    return true;
+  }
+
+  friend bool operator!=(const stack &lhs, const stack &rhs) { return !(lhs == rhs); }
+
   size_t count() const noexcept { return stack_base_.size(); }
   size_t size() const noexcept { return stack_base_.size(); }
   size_t capacity() const noexcept { return stack_base_.capacity(); }
@@ -75,5 +171,60 @@ public:
   bool full() const noexcept { return stack_base_.full(); }
 
 private:
+  size_t next_capacity() const noexcept {
+    return 1 + capacity() * Growth::num / Growth::den;
+  }
+
+  void check_size(size_t n) const {
+    if (n > size())
+      throw "not enough elements in stack";
+  }
+
+  void reallocate(size_t new_capacity) {
+    stack_base<T> new_base(new_capacity, stack_base_.tag_);
+    new_base.tag_.on_reallocate();
+    new_base.uninitialized_relocate(stack_base_.start_, stack_base_.end_, new_base.start_);
+    new_base.end_ = new_base.start_ + size();
+
+    stack_base_.destroy_range(stack_base_.start_, stack_base_.end_);
+    swap(stack_base_, new_base);
+  }
+
+  /* args may refer to elements of this stack, so the new top is built before they are relocated */
+  template <typename... Args> T &grow_and_emplace(Args &&...args) {
+    stack_base<T> new_base(next_capacity(), stack_base_.tag_);
+    new_base.tag_.on_reallocate();
+    new_base.construct(new_base.start_ + size(), std::forward<Args>(args)...);
+    try {
+      new_base.uninitialized_relocate(stack_base_.start_, stack_base_.end_, new_base.start_);
+    } catch (...) {
+      new_base.destroy(new_base.start_ + size());
+      throw;
+    }
+    new_base.end_ = new_base.start_ + size() + 1;
+
+    stack_base_.destroy_range(stack_base_.start_, stack_base_.end_);
+    swap(stack_base_, new_base);
+    return *(stack_base_.end_ - 1);
+  }
+
+  /* like grow_and_emplace, [first, last) may be part of this stack */
+  template <typename ForwardIt> void grow_and_push_range(ForwardIt first, ForwardIt last, size_t n) {
+    size_t grown = next_capacity();
+    stack_base<T> new_base(size() + n > grown ? size() + n : grown, stack_base_.tag_);
+    new_base.tag_.on_reallocate();
+    new_base.uninitialized_copy(first, last, new_base.start_ + size());
+    try {
+      new_base.uninitialized_relocate(stack_base_.start_, stack_base_.end_, new_base.start_);
+    } catch (...) {
+      new_base.destroy_range(new_base.start_ + size(), new_base.start_ + size() + n);
+      throw;
+    }
+    new_base.end_ = new_base.start_ + size() + n;
+
+    stack_base_.destroy_range(stack_base_.start_, stack_base_.end_);
+    swap(stack_base_, new_base);
+  }
+
   stack_base<T> stack_base_;
 };
\ No newline at end of file
@@ -1,13 +1,30 @@
+#pragma once
+
+#include "./../memory_accounting/memory_accounting.cpp"
+
+#include <cstring>
+#include <iterator>
+#include <memory>
 #include <new>
+#include <type_traits>
 #include <utility>
 
 template <typename T> class stack_base {
+  // contiguous ranges of trivially copyable T can be copied byte-wise
+  template <typename It>
+  static constexpr bool is_memcpyable =
+      std::is_trivially_copyable_v<T> && std::contiguous_iterator<It> &&
+      std::is_same_v<std::remove_cv_t<std::iter_value_t<It>>, T>;
+
 public:
   stack_base() : start_(nullptr), end_(nullptr), capacity_(nullptr) {}
 
-  stack_base(size_t capacity)
-      : start_(static_cast<T *>(::operator new(capacity * sizeof(T)))), end_(start_),
-        capacity_(start_ + capacity) {}
+  stack_base(size_t capacity, memory_tag tag = memory_tag())
+      : start_(capacity ? static_cast<T *>(::operator new(capacity * sizeof(T))) : nullptr),
+        end_(start_), capacity_(start_ + capacity), tag_(tag) {
+    if (start_)
+      tag_.on_allocate(capacity * sizeof(T));
+  }
 
   // delete copy operations
   stack_base(const stack_base &) = delete;
@@ -15,7 +32,7 @@ public:
 
   // move constructor
   stack_base(stack_base &&oth) noexcept
-      : start_(oth.start_), end_(oth.end_), capacity_(oth.capacity_) {
+      : start_(oth.start_), end_(oth.end_), capacity_(oth.capacity_), tag_(oth.tag_) {
     oth.start_ = oth.capacity_ = oth.end_ = nullptr;
   }
 
@@ -29,8 +46,10 @@ public:
 
   // destructor
   ~stack_base() {
-    if (start_)
-      ::operator delete(start_, capacity());
+    if (start_) {
+      tag_.on_deallocate(capacity() * sizeof(T));
+      ::operator delete(start_, capacity() * sizeof(T));
+    }
   }
 
   // noexcept swap
@@ -39,9 +58,12 @@ public:
     swap(lhs.start_, rhs.start_);
     swap(lhs.end_, rhs.end_);
     swap(lhs.capacity_, rhs.capacity_);
+    swap(lhs.tag_, rhs.tag_);
   }
 
-  void construct(T *dst, const T &val) { new (&*dst) T(val); }
+  template <typename... Args> void construct(T *dst, Args &&...args) {
+    new (&*dst) T(std::forward<Args>(args)...);
+  }
   void destroy(T *src) { src->~T(); }
 
   void destroy_range(T *src, T *dst) {
@@ -55,10 +77,20 @@ public:
   bool empty() const noexcept { return 0 == size(); }
   bool full() const noexcept { return size() == capacity(); }
 
-  /* copies T from [src_begin, src_end) to memory starting from dst_begin */
-  void uninitialized_copy(T *src_begin, T *src_end, T *dst_begin) {
+  /*
+  copies T from [src_begin, src_end) to memory starting from dst_begin. a contiguous range
+  of trivially copyable T is copied with one memcpy
+  */
+  template <typename InputIt> void uninitialized_copy(InputIt src_begin, InputIt src_end, T *dst_begin) {
+    if constexpr (is_memcpyable<InputIt>) {
+      if (src_begin != src_end)
+        std::memcpy(static_cast<void *>(dst_begin), std::to_address(src_begin),
+                    (src_end - src_begin) * sizeof(T));
+      return;
+    }
+
     T *dst = dst_begin;
-    T *src = src_begin;
+    InputIt src = src_begin;
 
     try {
       for (; src != src_end; ++src, ++dst)
@@ -71,8 +103,13 @@ public:
   }
 
   /* moves T from [src_begin, src_end) to memory starting from dst_begin */
-  void uninitialized_move(T *src_begin, T *src_end, T *dst_begin) {
-    T *src = src_begin;
+  template <typename InputIt> void uninitialized_move(InputIt src_begin, InputIt src_end, T *dst_begin) {
+    if constexpr (is_memcpyable<InputIt>) {
+      uninitialized_copy(src_begin, src_end, dst_begin);
+      return;
+    }
+
+    InputIt src = src_begin;
     T *dst = dst_begin;
 
     try {
@@ -85,7 +122,26 @@ public:
     }
   }
 
+  /*
+  moves [src_begin, src_end) into memory starting from dst_begin the way move_if_noexcept
+  would: trivially copyable T is copied with memcpy, T with a noexcept (or the only) move
+  constructor is moved, anything else is copied so that the source survives an exception.
+  the source elements are left for the caller to destroy
+  */
+  void uninitialized_relocate(T *src_begin, T *src_end, T *dst_begin) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (src_begin != src_end)
+        std::memcpy(static_cast<void *>(dst_begin), src_begin, (src_end - src_begin) * sizeof(T));
+    } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+      uninitialized_move(src_begin, src_end, dst_begin);
+    } else {
+      uninitialized_copy(src_begin, src_end, dst_begin);
+    }
+  }
+
   T *start_;    // points to area of memory
   T *end_;      // points to where next element will be inserted
   T *capacity_; // points to the last memory region + 1
+
+  [[no_unique_address]] memory_tag tag_; // accounts the storage, travels with it on swap
 };
\ No newline at end of file
@@ -2,8 +2,16 @@
 
 #include "./../Widget/widget.cpp" // Assuming Widget definition is here
 #include "stack.cpp"              // Assuming your stack class is in stack.cpp
+#include "elimination_stack.cpp"
+#include "inline_stack.cpp"
+#include "segmented_stack.cpp"
+#include "lockfree_stack.cpp"
 #include <boost/test/included/unit_test.hpp>
 #include <boost/test/unit_test.hpp> // Include for specific assertions
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector> // Useful for comparing stack contents easily if needed, or just for structure
 
 // Helper function to create a stack with specific content for testing
@@ -22,6 +30,13 @@ template <typename T> stack<T> create_stack_with_data(const std::vector<T> &data
 // Assuming operator== and operator!= for stack<T> are correctly implemented
 // and operator== for Widget is also implemented.
 
+// BOOST_CHECK_EQUAL(st1, st2) would also need operator<< to print a failing stack
+BOOST_TEST_DONT_PRINT_LOG_VALUE(stack<Widget>)
+using inline_widget_stack = inline_stack<Widget, 2>;
+BOOST_TEST_DONT_PRINT_LOG_VALUE(inline_widget_stack)
+using segmented_widget_stack = segmented_stack<Widget, 2>;
+BOOST_TEST_DONT_PRINT_LOG_VALUE(segmented_widget_stack)
+
 BOOST_AUTO_TEST_SUITE(StackTestSuite)
 
 // --- Basic State Tests ---
@@ -734,4 +749,691 @@ BOOST_AUTO_TEST_CASE(Stack_Int_Resize) {
   BOOST_CHECK_EQUAL(st.top(), 4);
 }
 
+// --- Growth, reserve and shrink_to_fit ---
+
+// copying throws once armed, and the move constructor is not noexcept, so relocation must copy
+struct ThrowingCopy {
+  static inline int copies_left = -1;
+
+  ThrowingCopy(int x) : x_(x) {}
+  ThrowingCopy(const ThrowingCopy &oth) : x_(oth.x_) {
+    if (copies_left == 0)
+      throw "copy failed";
+    if (copies_left > 0)
+      --copies_left;
+  }
+  ThrowingCopy(ThrowingCopy &&oth) : x_(oth.x_) {}
+
+  friend bool operator==(const ThrowingCopy &lhs, const ThrowingCopy &rhs) { return lhs.x_ == rhs.x_; }
+
+  int x_;
+};
+
+BOOST_AUTO_TEST_CASE(Stack_GrowsGeometrically) {
+  stack<int> st;
+  for (int i = 0; i != 1000000; ++i)
+    st.push(i);
+
+  BOOST_CHECK_EQUAL(st.size(), 1000000);
+  BOOST_CHECK_EQUAL(st.capacity(), (size_t(1) << 20) - 1); // 2^k - 1 for the default factor
+  for (int i = 999999; i >= 0; --i) {
+    BOOST_REQUIRE_EQUAL(st.top(), i);
+    st.pop();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Stack_CustomGrowthFactor) {
+  stack<std::string, std::ratio<3, 2>> st;
+  for (int i = 0; i != 5; ++i)
+    st.push(std::to_string(i));
+
+  // 0 -> 1 -> 2 -> 4 -> 7
+  BOOST_CHECK_EQUAL(st.capacity(), 7);
+  BOOST_CHECK_EQUAL(st.top(), "4");
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PushOwnTopWhileGrowing) {
+  stack<std::string> st;
+  st.push("a long string that does not fit the small string buffer");
+  BOOST_CHECK(st.full());
+
+  st.push(st.top());
+  BOOST_CHECK_EQUAL(st.size(), 2);
+  st.pop();
+  BOOST_CHECK_EQUAL(st.top(), "a long string that does not fit the small string buffer");
+}
+
+BOOST_AUTO_TEST_CASE(Stack_ReserveAndShrinkToFit) {
+  stack<Widget> st;
+  st.reserve(10);
+  BOOST_CHECK_EQUAL(st.capacity(), 10);
+  st.reserve(5); // never shrinks
+  BOOST_CHECK_EQUAL(st.capacity(), 10);
+
+  st.push(Widget(1));
+  st.push(Widget(2));
+  st.shrink_to_fit();
+  BOOST_CHECK_EQUAL(st.capacity(), 2);
+  BOOST_CHECK_EQUAL(st.top(), Widget(2));
+
+  st.pop();
+  st.pop();
+  st.shrink_to_fit();
+  BOOST_CHECK_EQUAL(st.capacity(), 0);
+  st.push(Widget(3));
+  BOOST_CHECK_EQUAL(st.capacity(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_GrowthIsStronglyExceptionSafe) {
+  stack<ThrowingCopy> st;
+  for (int i = 0; i != 3; ++i)
+    st.push(ThrowingCopy(i));
+  BOOST_REQUIRE(st.full());
+  stack<ThrowingCopy> before(st);
+
+  ThrowingCopy::copies_left = 2; // two relocated elements are copied, the pushed value is moved
+  BOOST_CHECK_THROW(st.push(ThrowingCopy(3)), const char *);
+  ThrowingCopy::copies_left = -1;
+
+  BOOST_CHECK_EQUAL(st.capacity(), 3);
+  BOOST_CHECK(st == before);
+}
+
+// --- move, emplace and pop_value ---
+
+struct ThrowingMove {
+  static inline bool throw_on_move = false;
+
+  ThrowingMove(int x) : x_(x) {}
+  ThrowingMove(const ThrowingMove &oth) = default;
+  ThrowingMove(ThrowingMove &&oth) : x_(oth.x_) {
+    if (throw_on_move)
+      throw "move failed";
+  }
+  ThrowingMove &operator=(ThrowingMove &&oth) {
+    if (throw_on_move)
+      throw "move failed";
+    x_ = oth.x_;
+    return *this;
+  }
+
+  int x_;
+};
+
+BOOST_AUTO_TEST_CASE(Stack_PushRvalueMoves) {
+  stack<Widget> st(2);
+  Widget w(1);
+  Widget::reset_counters();
+  st.push(std::move(w));
+  st.push(Widget(2));
+  BOOST_CHECK_EQUAL(Widget::copies, 0);
+  BOOST_CHECK_EQUAL(Widget::moves, 2);
+  BOOST_CHECK_EQUAL(st.top(), Widget(2));
+}
+
+BOOST_AUTO_TEST_CASE(Stack_EmplaceConstructsInPlace) {
+  stack<Widget> st(1);
+  Widget::reset_counters();
+  Widget &top = st.emplace(7);
+  BOOST_CHECK_EQUAL(Widget::copies, 0);
+  BOOST_CHECK_EQUAL(Widget::moves, 0);
+  BOOST_CHECK_EQUAL(&top, &st.top());
+  BOOST_CHECK_EQUAL(top, Widget(7));
+
+  // growing relocates with Widget's noexcept move
+  st.emplace(8);
+  st.emplace(9);
+  BOOST_CHECK_EQUAL(Widget::copies, 0);
+  BOOST_CHECK_EQUAL(st.size(), 3);
+
+  stack<std::string> strings;
+  strings.emplace(3, 'x');
+  BOOST_CHECK_EQUAL(strings.top(), "xxx");
+}
+
+BOOST_AUTO_TEST_CASE(Stack_EmplaceOwnTopWhileGrowing) {
+  stack<std::string> st;
+  st.emplace("a long string that does not fit the small string buffer");
+  BOOST_CHECK(st.full());
+
+  st.emplace(st.top(), 2); // substring constructor from an element about to be relocated
+  BOOST_CHECK_EQUAL(st.top(), "long string that does not fit the small string buffer");
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PopValueMovesTheTopOut) {
+  stack<Widget> st;
+  st.emplace(1);
+  st.emplace(2);
+  Widget::reset_counters();
+  Widget w = st.pop_value();
+  BOOST_CHECK_EQUAL(Widget::copies, 0);
+  BOOST_CHECK_EQUAL(Widget::moves, 1);
+  BOOST_CHECK_EQUAL(w, Widget(2));
+  BOOST_CHECK_EQUAL(st.size(), 1);
+
+  st.pop();
+  BOOST_CHECK_THROW(st.pop_value(), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PopValueIsStronglyExceptionSafe) {
+  stack<ThrowingMove> st(2);
+  st.emplace(1);
+  st.emplace(2);
+
+  ThrowingMove::throw_on_move = true;
+  BOOST_CHECK_THROW(st.pop_value(), const char *);
+  ThrowingMove::throw_on_move = false;
+
+  BOOST_CHECK_EQUAL(st.size(), 2);
+  BOOST_CHECK_EQUAL(st.top().x_, 2);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_HotPathMakesNoCopies) {
+  stack<Widget> st;
+  inline_stack<Widget, 4> small;
+  Widget::reset_counters();
+  for (int i = 0; i != 40; ++i) {
+    st.emplace(i);
+    small.emplace(i);
+    st.push(st.pop_value());
+    small.push(small.pop_value());
+  }
+  BOOST_CHECK_EQUAL(Widget::copies, 0);
+  BOOST_CHECK_EQUAL(st.size(), 40);
+  BOOST_CHECK_EQUAL(small.top(), Widget(39));
+}
+
+// --- push_range and pop_n ---
+
+BOOST_AUTO_TEST_CASE(Stack_PushRangeSizesOnce) {
+  stack<int> st;
+  st.push(0);
+  std::vector<int> run{1, 2, 3, 4, 5};
+  st.push_range(run.begin(), run.end());
+  BOOST_CHECK_EQUAL(st.size(), 6);
+  BOOST_CHECK_EQUAL(st.capacity(), 6); // one reallocation, to exactly what was needed
+  BOOST_CHECK_EQUAL(st.top(), 5);
+
+  st.push_range(run.begin(), run.begin() + 2);
+  BOOST_CHECK_EQUAL(st.capacity(), 13); // geometric growth wins over the exact size
+  st.push_range(run.begin(), run.begin()); // empty run
+  BOOST_CHECK_EQUAL(st.size(), 8);
+  BOOST_CHECK_EQUAL(st.top(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PushRangeFromItself) {
+  stack<std::string> st;
+  st.push("a long string that does not fit the small string buffer");
+  st.push("b");
+  std::vector<std::string> own;
+  st.pop_n(2, std::back_inserter(own));
+  st.push_range(own.rbegin(), own.rend());
+
+  // the source is relocated by the same push
+  std::string *first = &st.top() - 1;
+  st.push_range(first, first + 2);
+  BOOST_CHECK_EQUAL(st.size(), 4);
+  BOOST_CHECK_EQUAL(st.pop_value(), "b");
+  BOOST_CHECK_EQUAL(st.pop_value(), "a long string that does not fit the small string buffer");
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PushRangeFromInputIterator) {
+  std::istringstream in("1 2 3");
+  stack<int> st;
+  st.push_range(std::istream_iterator<int>(in), std::istream_iterator<int>());
+  BOOST_CHECK_EQUAL(st.size(), 3);
+  BOOST_CHECK_EQUAL(st.top(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PushRangeMovesWithMoveIterators) {
+  stack<Widget> st(4);
+  std::vector<Widget> run;
+  run.emplace_back(1);
+  run.emplace_back(2);
+  Widget::reset_counters();
+  st.push_range(std::make_move_iterator(run.begin()), std::make_move_iterator(run.end()));
+  BOOST_CHECK_EQUAL(Widget::copies, 0);
+  BOOST_CHECK_EQUAL(Widget::moves, 2);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PushRangeIsStronglyExceptionSafe) {
+  stack<ThrowingCopy> st;
+  st.push(ThrowingCopy(0));
+  stack<ThrowingCopy> before(st);
+  std::vector<ThrowingCopy> run{ThrowingCopy(1), ThrowingCopy(2), ThrowingCopy(3)};
+
+  ThrowingCopy::copies_left = 2;
+  BOOST_CHECK_THROW(st.push_range(run.begin(), run.end()), const char *);
+  ThrowingCopy::copies_left = -1;
+  BOOST_CHECK(st == before);
+  BOOST_CHECK_EQUAL(st.capacity(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Stack_PopN) {
+  stack<int> st;
+  for (int i = 0; i != 6; ++i)
+    st.push(i);
+
+  st.pop_n(2);
+  BOOST_CHECK_EQUAL(st.top(), 3);
+
+  std::vector<int> out;
+  st.pop_n(3, std::back_inserter(out));
+  BOOST_CHECK(out == (std::vector<int>{3, 2, 1}));
+  BOOST_CHECK_EQUAL(st.top(), 0);
+
+  BOOST_CHECK_THROW(st.pop_n(2), const char *);
+  BOOST_CHECK_EQUAL(st.size(), 1);
+  st.pop_n(0);
+  st.pop_n(1);
+  BOOST_CHECK(st.empty());
+}
+
+// --- lockfree_stack ---
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_PushPopIsLifo) {
+  lockfree_stack<Widget> st(4);
+  BOOST_CHECK(st.empty());
+  BOOST_CHECK(!st.pop().has_value());
+
+  BOOST_CHECK(st.push(Widget(1)));
+  BOOST_CHECK(st.push(Widget(2)));
+  BOOST_CHECK_EQUAL(*st.pop(), Widget(2));
+
+  Widget w;
+  BOOST_CHECK(st.pop(w));
+  BOOST_CHECK_EQUAL(w, Widget(1));
+  BOOST_CHECK(!st.pop(w));
+  BOOST_CHECK(st.empty());
+}
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_IsBounded) {
+  lockfree_stack<int> st(3);
+  BOOST_CHECK(st.push(1));
+  BOOST_CHECK(st.push(2));
+  BOOST_CHECK(st.push(3));
+  BOOST_CHECK(!st.push(4));
+
+  // popped nodes go back to the pool
+  BOOST_CHECK_EQUAL(*st.pop(), 3);
+  BOOST_CHECK(st.push(5));
+  BOOST_CHECK_EQUAL(*st.pop(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_PushListAndPopAll) {
+  lockfree_stack<int> st(5);
+  st.push(0);
+  std::vector<int> batch{1, 2, 3, 4, 5, 6};
+  BOOST_CHECK_EQUAL(st.push_list(batch.begin(), batch.end()), 4); // the pool holds 5
+
+  std::vector<int> out;
+  BOOST_CHECK_EQUAL(st.pop_all(std::back_inserter(out)), 5);
+  BOOST_CHECK(out == (std::vector<int>{4, 3, 2, 1, 0}));
+  BOOST_CHECK(st.empty());
+  BOOST_CHECK_EQUAL(st.pop_all(std::back_inserter(out)), 0);
+
+  // the whole pool is free again
+  BOOST_CHECK_EQUAL(st.push_list(batch.begin(), batch.end()), 5);
+}
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_PushListIsExceptionSafe) {
+  lockfree_stack<ThrowingCopy> st(4);
+  std::vector<ThrowingCopy> batch{ThrowingCopy(1), ThrowingCopy(2), ThrowingCopy(3)};
+
+  ThrowingCopy::copies_left = 2;
+  BOOST_CHECK_THROW(st.push_list(batch.begin(), batch.end()), const char *);
+  ThrowingCopy::copies_left = -1;
+
+  // the two values built before the throw are pushed, no node is lost
+  std::vector<ThrowingCopy> out;
+  BOOST_CHECK_EQUAL(st.pop_all(std::back_inserter(out)), 2);
+  BOOST_CHECK_EQUAL(st.push_list(batch.begin(), batch.end()), 3);
+  BOOST_CHECK(st.push(ThrowingCopy(4)));
+  BOOST_CHECK(!st.push(ThrowingCopy(5)));
+}
+
+// an output iterator that takes limit values, then throws
+struct LimitedOutput {
+  std::vector<int> *out;
+  size_t limit;
+
+  LimitedOutput &operator*() { return *this; }
+  LimitedOutput &operator++(int) { return *this; }
+  LimitedOutput &operator=(int &&val) {
+    if (out->size() == limit)
+      throw "output full";
+    out->push_back(val);
+    return *this;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_PopIsExceptionSafe) {
+  lockfree_stack<ThrowingMove> st(2);
+  BOOST_CHECK(st.push(ThrowingMove(1)));
+  BOOST_CHECK(st.push(ThrowingMove(2)));
+
+  ThrowingMove out(0);
+  ThrowingMove::throw_on_move = true;
+  BOOST_CHECK_THROW(st.pop(out), const char *);
+  BOOST_CHECK_THROW(st.pop(), const char *);
+  ThrowingMove::throw_on_move = false;
+
+  // both values are lost, but their nodes are back in the pool
+  BOOST_CHECK(st.empty());
+  BOOST_CHECK(st.push(ThrowingMove(3)));
+  BOOST_CHECK(st.push(ThrowingMove(4)));
+  BOOST_CHECK(!st.push(ThrowingMove(5)));
+}
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_PopAllIsExceptionSafe) {
+  lockfree_stack<int> st(5);
+  std::vector<int> batch{1, 2, 3, 4, 5};
+  BOOST_CHECK_EQUAL(st.push_list(batch.begin(), batch.end()), 5);
+
+  // 5 and 4 are taken, 3 is lost in the throw, 2 and 1 stay on the stack
+  std::vector<int> out;
+  BOOST_CHECK_THROW(st.pop_all(LimitedOutput{&out, 2}), const char *);
+  BOOST_CHECK(out == (std::vector<int>{5, 4}));
+  BOOST_CHECK_EQUAL(*st.pop(), 2);
+  BOOST_CHECK_EQUAL(*st.pop(), 1);
+  BOOST_CHECK(st.empty());
+
+  // no node is lost
+  BOOST_CHECK_EQUAL(st.push_list(batch.begin(), batch.end()), 5);
+}
+
+BOOST_AUTO_TEST_CASE(LockfreeStack_ConcurrentPushPopLosesNothing) {
+  const int threads = 4, per_thread = 20000;
+  lockfree_stack<int> st(64);
+  std::vector<long long> sums(threads, 0);
+  std::vector<std::thread> workers;
+
+  // every thread pushes its own values and pops whatever is on top, nodes are recycled
+  // constantly, which is what breaks a Treiber stack without ABA protection
+  for (int t = 0; t != threads; ++t)
+    workers.emplace_back([&, t] {
+      for (int i = 0; i != per_thread; ++i) {
+        int val = t * per_thread + i;
+        while (!st.push(val))
+          std::this_thread::yield();
+        if (i % 3 == 2) {
+          std::vector<int> out;
+          st.pop_all(std::back_inserter(out));
+          for (int v : out)
+            sums[t] += v;
+        } else if (std::optional<int> v = st.pop()) {
+          sums[t] += *v;
+        }
+      }
+    });
+  for (std::thread &w : workers)
+    w.join();
+
+  long long total = 0;
+  for (long long s : sums)
+    total += s;
+  while (std::optional<int> v = st.pop())
+    total += *v;
+
+  long long n = (long long)threads * per_thread;
+  BOOST_CHECK_EQUAL(total, n * (n - 1) / 2);
+}
+
+// --- elimination_stack ---
+
+BOOST_AUTO_TEST_CASE(EliminationStack_PushPopIsLifo) {
+  elimination_stack<Widget> st(2);
+  BOOST_CHECK(!st.pop().has_value());
+  BOOST_CHECK(st.push(Widget(1)));
+  BOOST_CHECK(st.push(Widget(2)));
+  BOOST_CHECK(!st.push(Widget(3)));
+
+  BOOST_CHECK_EQUAL(*st.pop(), Widget(2));
+  Widget w;
+  BOOST_CHECK(st.pop(w));
+  BOOST_CHECK_EQUAL(w, Widget(1));
+  BOOST_CHECK(st.empty());
+}
+
+BOOST_AUTO_TEST_CASE(EliminationStack_PopIsExceptionSafe) {
+  elimination_stack<ThrowingMove> st(1);
+  BOOST_CHECK(st.push(ThrowingMove(1)));
+
+  ThrowingMove::throw_on_move = true;
+  BOOST_CHECK_THROW(st.pop(), const char *);
+  ThrowingMove::throw_on_move = false;
+
+  // the value is lost, its node is back in the pool
+  BOOST_CHECK(st.empty());
+  BOOST_CHECK(st.push(ThrowingMove(2)));
+  BOOST_CHECK_EQUAL(st.pop()->x_, 2);
+}
+
+BOOST_AUTO_TEST_CASE(EliminationStack_ConcurrentPairsLoseNothing) {
+  const int threads = 8, per_thread = 20000;
+  elimination_stack<int, 4> st(256);
+  std::vector<long long> sums(threads, 0);
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t != threads; ++t)
+    workers.emplace_back([&, t] {
+      for (int i = 0; i != per_thread; ++i) {
+        int val = t * per_thread + i;
+        while (!st.push(val))
+          std::this_thread::yield();
+        if (std::optional<int> v = st.pop())
+          sums[t] += *v;
+      }
+    });
+  for (std::thread &w : workers)
+    w.join();
+
+  long long total = 0;
+  for (long long s : sums)
+    total += s;
+  while (std::optional<int> v = st.pop())
+    total += *v;
+
+  long long n = (long long)threads * per_thread;
+  BOOST_CHECK_EQUAL(total, n * (n - 1) / 2);
+}
+
+// --- inline_stack ---
+
+BOOST_AUTO_TEST_CASE(InlineStack_StaysInlineUpToN) {
+  inline_stack<Widget, 2> st;
+  BOOST_CHECK(st.is_inline());
+  BOOST_CHECK_EQUAL(st.capacity(), 2);
+  st.push(Widget(1));
+  st.push(Widget(2));
+  BOOST_CHECK(st.is_inline());
+  BOOST_CHECK(st.full());
+
+  st.push(Widget(3));
+  BOOST_CHECK(!st.is_inline());
+  BOOST_CHECK_EQUAL(st.capacity(), 5);
+  BOOST_CHECK_EQUAL(st.top(), Widget(3));
+  st.pop();
+  BOOST_CHECK_EQUAL(st.top(), Widget(2));
+  st.pop();
+  st.pop();
+  BOOST_CHECK(st.empty());
+  BOOST_CHECK_THROW(st.pop(), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(InlineStack_PushOwnTopWhileSpilling) {
+  inline_stack<std::string, 1> st;
+  st.push(std::string(40, 'x'));
+  st.push(st.top());
+  BOOST_CHECK_EQUAL(st.size(), 2);
+  BOOST_CHECK_EQUAL(st.top(), std::string(40, 'x'));
+}
+
+BOOST_AUTO_TEST_CASE(InlineStack_CopyAndMoveInBothModes) {
+  inline_stack<Widget, 2> small, large;
+  small.push(Widget(1));
+  for (int i = 0; i != 4; ++i)
+    large.push(Widget(i));
+
+  inline_stack<Widget, 2> small_copy(small), large_copy(large);
+  BOOST_CHECK(small_copy == small);
+  BOOST_CHECK(large_copy == large);
+  BOOST_CHECK(small_copy.is_inline());
+  BOOST_CHECK(!large_copy.is_inline());
+  BOOST_CHECK_EQUAL(large_copy.capacity(), 4); // copies are sized to fit
+
+  inline_stack<Widget, 2> small_moved(std::move(small_copy)), large_moved(std::move(large_copy));
+  BOOST_CHECK(small_moved == small);
+  BOOST_CHECK(large_moved == large);
+  BOOST_CHECK(small_copy.empty() && small_copy.is_inline());
+  BOOST_CHECK(large_copy.empty() && large_copy.is_inline());
+
+  small_moved = large;
+  BOOST_CHECK(small_moved == large);
+  large_moved = std::move(small_copy);
+  BOOST_CHECK(large_moved.empty() && large_moved.is_inline());
+}
+
+BOOST_AUTO_TEST_CASE(InlineStack_SwapInBothModes) {
+  inline_stack<Widget, 2> a, b, c;
+  a.push(Widget(1));
+  for (int i = 0; i != 3; ++i)
+    b.push(Widget(i));
+  for (int i = 0; i != 4; ++i)
+    c.push(Widget(i + 10));
+  inline_stack<Widget, 2> a0(a), b0(b), c0(c);
+
+  swap(a, b); // inline with heap
+  BOOST_CHECK(a == b0 && b == a0);
+  BOOST_CHECK(b.is_inline());
+  swap(a, c); // heap with heap
+  BOOST_CHECK(a == c0 && c == b0);
+  swap(b, b); // inline with itself
+  BOOST_CHECK(b == a0);
+}
+
+BOOST_AUTO_TEST_CASE(InlineStack_ShrinkToFitMovesBackInline) {
+  inline_stack<Widget, 2> st;
+  for (int i = 0; i != 5; ++i)
+    st.push(Widget(i));
+  st.pop();
+  st.shrink_to_fit();
+  BOOST_CHECK_EQUAL(st.capacity(), 4);
+
+  st.pop();
+  st.pop();
+  st.shrink_to_fit();
+  BOOST_CHECK(st.is_inline());
+  BOOST_CHECK_EQUAL(st.capacity(), 2);
+  BOOST_CHECK_EQUAL(st.top(), Widget(1));
+
+  st.reserve(10);
+  BOOST_CHECK(!st.is_inline());
+  BOOST_CHECK_EQUAL(st.capacity(), 10);
+  BOOST_CHECK_EQUAL(st.top(), Widget(1));
+}
+
+BOOST_AUTO_TEST_CASE(InlineStack_SpillIsStronglyExceptionSafe) {
+  inline_stack<ThrowingCopy, 2> st;
+  st.push(ThrowingCopy(0));
+  st.push(ThrowingCopy(1));
+  inline_stack<ThrowingCopy, 2> before(st);
+
+  ThrowingCopy::copies_left = 1; // the pushed value is moved, one relocated element is copied
+  BOOST_CHECK_THROW(st.push(ThrowingCopy(2)), const char *);
+  ThrowingCopy::copies_left = -1;
+
+  BOOST_CHECK(st.is_inline());
+  BOOST_CHECK(st == before);
+}
+
+// --- segmented_stack ---
+
+BOOST_AUTO_TEST_CASE(SegmentedStack_PushPopAcrossSegments) {
+  segmented_stack<int, 4> st;
+  BOOST_CHECK(st.empty());
+  BOOST_CHECK_THROW(st.pop(), const char *);
+  BOOST_CHECK_THROW(st.top(), const char *);
+
+  for (int i = 0; i != 10; ++i)
+    st.push(i);
+  BOOST_CHECK_EQUAL(st.size(), 10);
+  BOOST_CHECK_EQUAL(st.segments(), 3);
+
+  for (int i = 10; i-- != 0;)
+    BOOST_CHECK_EQUAL(st.pop_value(), i);
+  BOOST_CHECK(st.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedStack_ElementsNeverMove) {
+  segmented_stack<std::string, 2> st;
+  st.push("first");
+  std::string *first = &st.top();
+  for (int i = 0; i != 101; ++i)
+    st.emplace(3, 'x');
+  BOOST_CHECK_EQUAL(*first, "first"); // still valid after 50 more segments
+
+  st.emplace(st.top()); // the top segment is full, the argument stays valid
+  BOOST_CHECK_EQUAL(st.top(), "xxx");
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedStack_CachesOneSegmentAtTheBoundary) {
+  segmented_stack<int, 4> st;
+  for (int i = 0; i != 4; ++i)
+    st.push(i);
+  BOOST_CHECK_EQUAL(st.segments(), 1);
+
+  // alternating across the boundary allocates the second segment once and keeps it
+  for (int i = 0; i != 10; ++i) {
+    st.push(4);
+    BOOST_CHECK_EQUAL(st.segments(), 2);
+    st.pop();
+    BOOST_CHECK_EQUAL(st.segments(), 2);
+  }
+
+  // draining keeps at most one emptied segment above the top
+  for (int i = 0; i != 8; ++i)
+    st.push(i);
+  BOOST_CHECK_EQUAL(st.segments(), 3);
+  while (!st.empty())
+    st.pop();
+  BOOST_CHECK_EQUAL(st.segments(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedStack_CopyMoveSwap) {
+  segmented_stack<Widget, 2> a, b;
+  for (int i = 0; i != 5; ++i)
+    a.push(Widget(i));
+  b.push(Widget(9));
+
+  segmented_stack<Widget, 2> copy(a);
+  BOOST_CHECK(copy == a);
+  copy.pop();
+  BOOST_CHECK(copy != a);
+
+  segmented_stack<Widget, 2> moved(std::move(copy));
+  BOOST_CHECK(copy.empty());
+  BOOST_CHECK_EQUAL(moved.size(), 4);
+
+  swap(a, b);
+  BOOST_CHECK_EQUAL(a.top(), Widget(9));
+  BOOST_CHECK_EQUAL(b.size(), 5);
+
+  a = b;
+  BOOST_CHECK(a == b);
+  a = std::move(moved);
+  BOOST_CHECK_EQUAL(a.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedStack_ThrowingPushLeavesStackUnchanged) {
+  segmented_stack<Widget, 2> st;
+  st.push(Widget(1));
+  st.push(Widget(2));
+  BOOST_CHECK_THROW(st.emplace(43), std::invalid_argument); // Widget(43) throws
+  BOOST_CHECK_EQUAL(st.size(), 2);
+  BOOST_CHECK_EQUAL(st.top(), Widget(2));
+  st.push(Widget(3));
+  BOOST_CHECK_EQUAL(st.top(), Widget(3));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "./../benchmark.cpp"
+#include "strided_view.cpp"
+
+#include <cstdlib>
+
+/*
+float matrix transpose bandwidth (bytes read + written per second) as the matrix grows
+out of each cache level: a naive double loop, the blocked kernel, and the blocked kernel
+writing into a tiled layout
+usage: ./bench [max n]
+*/
+
+template <typename View> static void naive_transpose(const strided_view<const float, 2> &src, const View &dst) {
+  for (size_t i = 0; i != src.extent(0); ++i)
+    for (size_t j = 0; j != src.extent(1); ++j)
+      dst(j, i) = src(i, j);
+}
+
+int main(int argc, char **argv) {
+  size_t max_n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8192;
+
+  std::printf("%8s %12s %12s %12s   (GB/s)\n", "n", "naive", "blocked", "to tiled");
+  for (size_t n = 64; n <= max_n; n *= 2) {
+    vector<float> a(n * n, 1.0f), b(n * n, 0.0f);
+    strided_view<const float, 2> src(a, {n, n});
+    strided_view<float, 2> dst(b, {n, n});
+    strided_view<float, 2, layout_tiled<16, 16>> tiled(b, {n, n});
+
+    int repeat = n <= 1024 ? 20 : 3;
+    double bytes = 2.0 * n * n * sizeof(float);
+    double naive = best_of(repeat, [&] { naive_transpose(src, dst); });
+    double blocked = best_of(repeat, [&] { transpose(src, dst); });
+    double to_tiled = best_of(repeat, [&] { transpose(src, tiled); });
+    do_not_optimize(b[n]);
+
+    std::printf("%8zu %12.2f %12.2f %12.2f\n", n, bytes / naive / 1e9, bytes / blocked / 1e9,
+                bytes / to_tiled / 1e9);
+  }
+}
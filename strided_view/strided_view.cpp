@@ -0,0 +1,215 @@
+#include "./../vector/vector.cpp"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/*
+multi-dimensional views over contiguous storage, in the spirit of std::mdspan
+
+a view is a pointer plus a layout mapping that turns an index tuple into an offset. the
+view owns nothing; it is as cheap to copy as a pointer and stays valid while the vector
+it was made from is neither resized nor destroyed.
+
+  layout_right          row-major, the last index is contiguous (C order)
+  layout_left           column-major, the first index is contiguous (Fortran order)
+  layout_tiled<R, C>    2D only: R x C row-major tiles, stored tile after tile in
+                        row-major order, so a tile is one contiguous run of memory
+*/
+
+template <size_t Rank> using extents = std::array<size_t, Rank>;
+
+struct layout_right {
+  template <size_t Rank> class mapping {
+  public:
+    mapping() = default;
+    explicit mapping(const extents<Rank> &e) : extents_(e) {
+      size_t stride = 1;
+      for (size_t r = Rank; r-- != 0;) {
+        strides_[r] = stride;
+        stride *= e[r];
+      }
+    }
+
+    // the last stride is always 1, leaving it out lets the compiler vectorize row walks
+    template <typename... Idx> size_t operator()(Idx... idx) const noexcept {
+      const size_t i[] = {size_t(idx)...};
+      size_t offset = i[Rank - 1];
+      for (size_t r = 0; r + 1 < Rank; ++r)
+        offset += i[r] * strides_[r];
+      return offset;
+    }
+
+    size_t extent(size_t r) const noexcept { return extents_[r]; }
+    size_t stride(size_t r) const noexcept { return strides_[r]; }
+    size_t required_span_size() const noexcept { return Rank ? strides_[0] * extents_[0] : 1; }
+
+  private:
+    extents<Rank> extents_{};
+    extents<Rank> strides_{};
+  };
+};
+
+struct layout_left {
+  template <size_t Rank> class mapping {
+  public:
+    mapping() = default;
+    explicit mapping(const extents<Rank> &e) : extents_(e) {
+      size_t stride = 1;
+      for (size_t r = 0; r != Rank; ++r) {
+        strides_[r] = stride;
+        stride *= e[r];
+      }
+    }
+
+    template <typename... Idx> size_t operator()(Idx... idx) const noexcept {
+      const size_t i[] = {size_t(idx)...};
+      size_t offset = i[0];
+      for (size_t r = 1; r < Rank; ++r)
+        offset += i[r] * strides_[r];
+      return offset;
+    }
+
+    size_t extent(size_t r) const noexcept { return extents_[r]; }
+    size_t stride(size_t r) const noexcept { return strides_[r]; }
+    size_t required_span_size() const noexcept {
+      return Rank ? strides_[Rank - 1] * extents_[Rank - 1] : 1;
+    }
+
+  private:
+    extents<Rank> extents_{};
+    extents<Rank> strides_{};
+  };
+};
+
+template <size_t TileRows, size_t TileCols> struct layout_tiled {
+  static_assert(TileRows > 0 && TileCols > 0, "empty tile");
+
+  template <size_t Rank> class mapping {
+    static_assert(Rank == 2, "layout_tiled is a 2D layout");
+
+  public:
+    mapping() = default;
+    // the storage is padded to whole tiles, the padding is never addressed by the view
+    explicit mapping(const extents<2> &e)
+        : extents_(e), tiles_per_row_((e[1] + TileCols - 1) / TileCols) {}
+
+    size_t operator()(size_t row, size_t col) const noexcept {
+      size_t tile = (row / TileRows) * tiles_per_row_ + col / TileCols;
+      return tile * (TileRows * TileCols) + (row % TileRows) * TileCols + col % TileCols;
+    }
+
+    size_t extent(size_t r) const noexcept { return extents_[r]; }
+    size_t required_span_size() const noexcept {
+      return (extents_[0] + TileRows - 1) / TileRows * tiles_per_row_ * (TileRows * TileCols);
+    }
+
+  private:
+    extents<2> extents_{};
+    size_t tiles_per_row_ = 0;
+  };
+};
+
+template <typename T, size_t Rank, typename Layout = layout_right> class strided_view {
+public:
+  using mapping_type = typename Layout::template mapping<Rank>;
+
+  strided_view() : data_(nullptr) {}
+  strided_view(T *data, const extents<Rank> &e) : data_(data), mapping_(e) {}
+
+  /* views the elements of a vector, which must hold at least required_span_size() of them */
+  template <typename Vec, typename = decltype(std::declval<Vec &>().data())>
+  strided_view(Vec &storage, const extents<Rank> &e) : strided_view(storage.data(), e) {
+    if (storage.size() < mapping_.required_span_size())
+      throw "vector too small for view";
+  }
+
+  template <typename... Idx> T &operator()(Idx... idx) const noexcept {
+    static_assert(sizeof...(Idx) == Rank, "one index per dimension");
+    return data_[mapping_(idx...)];
+  }
+
+  size_t extent(size_t r) const noexcept { return mapping_.extent(r); }
+
+  size_t size() const noexcept {
+    size_t n = 1;
+    for (size_t r = 0; r != Rank; ++r)
+      n *= extent(r);
+    return n;
+  }
+
+  size_t required_span_size() const noexcept { return mapping_.required_span_size(); }
+
+  T *data() const noexcept { return data_; }
+  const mapping_type &mapping() const noexcept { return mapping_; }
+
+  // a view of T converts to a view of const T
+  operator strided_view<const T, Rank, Layout>() const
+    requires(!std::is_const_v<T>)
+  {
+    return strided_view<const T, Rank, Layout>(data_, mapping_);
+  }
+
+private:
+  template <typename, size_t, typename> friend class strided_view;
+
+  strided_view(T *data, const mapping_type &mapping) : data_(data), mapping_(mapping) {}
+
+  T *data_;
+  mapping_type mapping_;
+};
+
+/*
+calls func(row, col, rows, cols) for every tile_rows x tile_cols tile of a 2D view in
+row-major tile order; tiles on the bottom and right edges are clipped to the view
+*/
+template <typename T, typename Layout, typename Func>
+void for_each_tile(const strided_view<T, 2, Layout> &view, size_t tile_rows, size_t tile_cols,
+                   Func &&func) {
+  const size_t rows = view.extent(0), cols = view.extent(1);
+  for (size_t i = 0; i < rows; i += tile_rows)
+    for (size_t j = 0; j < cols; j += tile_cols)
+      func(i, j, tile_rows < rows - i ? tile_rows : rows - i,
+           tile_cols < cols - j ? tile_cols : cols - j);
+}
+
+/*
+copies src into dst one Block x Block tile at a time, which keeps both sides in cache
+when their layouts differ (e.g. row-major into column-major or tiled)
+*/
+template <size_t Block = 32, typename T, typename U, typename SrcLayout, typename DstLayout>
+void copy(const strided_view<T, 2, SrcLayout> &src, const strided_view<U, 2, DstLayout> &dst) {
+  if (src.extent(0) != dst.extent(0) || src.extent(1) != dst.extent(1))
+    throw "extents mismatch";
+
+  for_each_tile(src, Block, Block, [&](size_t row, size_t col, size_t rows, size_t cols) {
+    for (size_t i = row; i != row + rows; ++i)
+      for (size_t j = col; j != col + cols; ++j)
+        dst(i, j) = src(i, j);
+  });
+}
+
+/*
+dst(j, i) = src(i, j), blocked: a naive transpose walks one side with a stride of a full
+row and touches a new cache line for every element once a row outgrows the cache.
+each Block x Block tile is read row by row into a local buffer and written out row by row,
+so both sides stream whole cache lines; writing straight into dst would leave Block
+partially written lines in flight, which for power-of-two row lengths all fall into the
+same cache set and evict each other
+*/
+template <size_t Block = 32, typename T, typename U, typename SrcLayout, typename DstLayout>
+void transpose(const strided_view<T, 2, SrcLayout> &src, const strided_view<U, 2, DstLayout> &dst) {
+  if (src.extent(0) != dst.extent(1) || src.extent(1) != dst.extent(0))
+    throw "extents mismatch";
+
+  std::remove_const_t<U> buffer[Block][Block];
+  for_each_tile(src, Block, Block, [&](size_t row, size_t col, size_t rows, size_t cols) {
+    for (size_t i = 0; i != rows; ++i)
+      for (size_t j = 0; j != cols; ++j)
+        buffer[j][i] = src(row + i, col + j);
+    for (size_t j = 0; j != cols; ++j)
+      for (size_t i = 0; i != rows; ++i)
+        dst(col + j, row + i) = buffer[j][i];
+  });
+}
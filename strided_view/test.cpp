@@ -0,0 +1,136 @@
+#define BOOST_TEST_MODULE StridedViewTests
+
+#include "strided_view.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+static vector<float> iota_vector(size_t n) {
+  vector<float> v(n, 0.0f);
+  for (size_t i = 0; i != n; ++i)
+    v[i] = float(i);
+  return v;
+}
+
+BOOST_AUTO_TEST_SUITE(StridedViewTestSuite)
+
+BOOST_AUTO_TEST_CASE(LayoutRight_RowMajor) {
+  vector<float> storage = iota_vector(12);
+  strided_view<float, 2> m(storage, {3, 4});
+
+  BOOST_CHECK_EQUAL(m.extent(0), 3);
+  BOOST_CHECK_EQUAL(m.extent(1), 4);
+  BOOST_CHECK_EQUAL(m.size(), 12);
+  BOOST_CHECK_EQUAL(m(0, 3), 3.0f);
+  BOOST_CHECK_EQUAL(m(2, 1), 9.0f);
+
+  m(1, 1) = -1.0f;
+  BOOST_CHECK_EQUAL(storage[5], -1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(LayoutLeft_ColumnMajor) {
+  vector<float> storage = iota_vector(12);
+  strided_view<float, 2, layout_left> m(storage, {3, 4});
+
+  BOOST_CHECK_EQUAL(m(2, 0), 2.0f);
+  BOOST_CHECK_EQUAL(m(0, 1), 3.0f);
+  BOOST_CHECK_EQUAL(m.mapping().stride(1), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Rank3) {
+  vector<float> storage = iota_vector(24);
+  strided_view<float, 3> right(storage, {2, 3, 4});
+  strided_view<float, 3, layout_left> left(storage, {2, 3, 4});
+
+  BOOST_CHECK_EQUAL(right(1, 2, 3), 23.0f);
+  BOOST_CHECK_EQUAL(right(1, 0, 0), 12.0f);
+  BOOST_CHECK_EQUAL(left(1, 0, 0), 1.0f);
+  BOOST_CHECK_EQUAL(left(0, 0, 1), 6.0f);
+}
+
+BOOST_AUTO_TEST_CASE(LayoutTiled_TilesAreContiguous) {
+  // 5 x 5 in 2 x 2 tiles is padded to 6 x 6
+  vector<float> storage = iota_vector(36);
+  strided_view<float, 2, layout_tiled<2, 2>> m(storage, {5, 5});
+
+  BOOST_CHECK_EQUAL(m.required_span_size(), 36);
+  BOOST_CHECK_EQUAL(m(0, 0), 0.0f);
+  BOOST_CHECK_EQUAL(m(0, 1), 1.0f);
+  BOOST_CHECK_EQUAL(m(1, 0), 2.0f);
+  BOOST_CHECK_EQUAL(m(1, 1), 3.0f);
+  BOOST_CHECK_EQUAL(m(0, 2), 4.0f);  // second tile
+  BOOST_CHECK_EQUAL(m(2, 0), 12.0f); // first tile of the second tile row
+  BOOST_CHECK_EQUAL(m(4, 4), 32.0f);
+}
+
+BOOST_AUTO_TEST_CASE(VectorTooSmall) {
+  vector<float> storage(10, 0.0f);
+  BOOST_CHECK_THROW((strided_view<float, 2>(storage, {3, 4})), const char *);
+  BOOST_CHECK_THROW((strided_view<float, 2, layout_tiled<4, 4>>(storage, {3, 3})), const char *);
+}
+
+BOOST_AUTO_TEST_CASE(ConstView) {
+  const vector<float> storage = iota_vector(6);
+  strided_view<const float, 2> m(storage, {2, 3});
+  BOOST_CHECK_EQUAL(m(1, 2), 5.0f);
+
+  vector<float> mutable_storage = iota_vector(6);
+  strided_view<float, 2> mv(mutable_storage, {2, 3});
+  strided_view<const float, 2> cv = mv;
+  BOOST_CHECK_EQUAL(cv(1, 0), 3.0f);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachTile_CoversEveryElementOnce) {
+  vector<float> storage(7 * 10, 0.0f);
+  strided_view<float, 2> m(storage, {7, 10});
+
+  size_t tiles = 0;
+  for_each_tile(m, 3, 4, [&](size_t row, size_t col, size_t rows, size_t cols) {
+    ++tiles;
+    for (size_t i = row; i != row + rows; ++i)
+      for (size_t j = col; j != col + cols; ++j)
+        m(i, j) += 1.0f;
+  });
+
+  BOOST_CHECK_EQUAL(tiles, 9);
+  for (float x : storage)
+    BOOST_REQUIRE_EQUAL(x, 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(Transpose_AcrossLayouts) {
+  const size_t rows = 67, cols = 45;
+  vector<float> src_storage = iota_vector(rows * cols);
+  strided_view<const float, 2> src(src_storage, {rows, cols});
+
+  vector<float> right_storage(rows * cols, 0.0f);
+  strided_view<float, 2> right(right_storage, {cols, rows});
+  transpose<16>(src, right);
+
+  vector<float> tiled_storage(48 * 80, 0.0f);
+  strided_view<float, 2, layout_tiled<16, 16>> tiled(tiled_storage, {cols, rows});
+  transpose(src, tiled);
+
+  for (size_t i = 0; i != rows; ++i)
+    for (size_t j = 0; j != cols; ++j) {
+      BOOST_REQUIRE_EQUAL(right(j, i), src(i, j));
+      BOOST_REQUIRE_EQUAL(tiled(j, i), src(i, j));
+    }
+
+  BOOST_CHECK_THROW(transpose(src, strided_view<float, 2>(right_storage, {rows, cols})),
+                    const char *);
+}
+
+BOOST_AUTO_TEST_CASE(Copy_RowMajorToColumnMajor) {
+  vector<float> src_storage = iota_vector(20);
+  strided_view<float, 2> src(src_storage, {4, 5});
+  vector<float> dst_storage(20, 0.0f);
+  strided_view<float, 2, layout_left> dst(dst_storage, {4, 5});
+
+  copy<3>(src, dst);
+  for (size_t i = 0; i != 4; ++i)
+    for (size_t j = 0; j != 5; ++j)
+      BOOST_REQUIRE_EQUAL(dst(i, j), src(i, j));
+  BOOST_CHECK_EQUAL(dst_storage[1], 5.0f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include "./../benchmark.cpp"
+#include "threadsafe_hash_map.cpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+read-heavy and write-heavy mixes across thread counts, against the serialized approach of
+one mutex around a std container
+usage: ./bench [max threads]
+*/
+
+// the serialized_queue approach applied to a map
+class serialized_map
+{
+public:
+    std::optional<uint64_t> find(uint64_t key) const
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = data_.find(key);
+        if (it == data_.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void insert_or_assign(uint64_t key, uint64_t value)
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        data_[key] = value;
+    }
+
+private:
+    std::unordered_map<uint64_t, uint64_t> data_;
+    mutable std::mutex m_;
+};
+
+template <typename Map>
+double run(Map &map, int threads, int write_percent, size_t ops_per_thread, uint64_t key_space)
+{
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t != threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            std::mt19937_64 rng(t);
+            uint64_t hits = 0;
+            while (!go.load())
+                ;
+            for (size_t i = 0; i != ops_per_thread; ++i)
+            {
+                uint64_t r = rng();
+                uint64_t key = r % key_space;
+                if (int((r >> 40) % 100) < write_percent)
+                    map.insert_or_assign(key, r);
+                else
+                    hits += map.find(key).has_value();
+            }
+            do_not_optimize(hits); });
+    }
+
+    double seconds = time_it([&]()
+                             {
+        go = true;
+        for (auto &w : workers)
+            w.join(); });
+    return threads * ops_per_thread / seconds / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : 32;
+    const size_t ops = 1'000'000;
+    const uint64_t key_space = 1'000'000;
+
+    std::printf("%8s %8s %16s %16s   (million ops per second)\n", "threads", "writes", "striped",
+                "one mutex");
+
+    for (int write_percent : {10, 50})
+    {
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            threadsafe_hash_map<uint64_t, uint64_t> striped;
+            serialized_map serialized;
+            for (uint64_t k = 0; k < key_space; k += 2)
+            {
+                striped.insert_or_assign(k, k);
+                serialized.insert_or_assign(k, k);
+            }
+
+            std::printf("%8d %7d%% %16.2f %16.2f\n", threads, write_percent,
+                        run(striped, threads, write_percent, ops, key_space),
+                        run(serialized, threads, write_percent, ops, key_space));
+        }
+    }
+}
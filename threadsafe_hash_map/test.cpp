@@ -0,0 +1,187 @@
+#define BOOST_TEST_MODULE ThreadsafeHashMapTests
+
+#include "threadsafe_hash_map.cpp"
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// identity hash that stalls the thread set in grower on key -1 until released
+struct stalling_hash
+{
+    static inline std::atomic<std::thread::id> grower{};
+    static inline std::atomic<bool> stalled{false};
+    static inline std::atomic<bool> released{false};
+
+    size_t operator()(int key) const
+    {
+        if (key == -1 && std::this_thread::get_id() == grower.load())
+        {
+            stalled = true;
+            while (!released)
+                std::this_thread::yield();
+        }
+        return std::hash<int>()(key);
+    }
+};
+
+BOOST_AUTO_TEST_SUITE(ThreadsafeHashMapTestSuite)
+
+BOOST_AUTO_TEST_CASE(Initialization)
+{
+    threadsafe_hash_map<int, int> map(10);
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK_EQUAL(map.stripe_count(), 16); // rounded up to a power of two
+    BOOST_CHECK(!map.find(1));
+}
+
+BOOST_AUTO_TEST_CASE(InsertFindErase)
+{
+    threadsafe_hash_map<std::string, int> map;
+    BOOST_CHECK(map.insert("a", 1));
+    BOOST_CHECK(!map.insert("a", 2)); // existing value is kept
+    BOOST_CHECK(map.insert_or_assign("b", 3));
+    BOOST_CHECK(!map.insert_or_assign("b", 4));
+
+    BOOST_CHECK_EQUAL(map.size(), 2);
+    BOOST_CHECK_EQUAL(*map.find("a"), 1);
+    BOOST_CHECK_EQUAL(*map.find("b"), 4);
+
+    BOOST_CHECK(map.erase("a"));
+    BOOST_CHECK(!map.erase("a"));
+    BOOST_CHECK(!map.contains("a"));
+    BOOST_CHECK_EQUAL(map.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Update)
+{
+    threadsafe_hash_map<int, int> map;
+    map.update(7, [](int &v)
+               { v += 5; });
+    map.update(7, [](int &v)
+               { v *= 2; });
+    BOOST_CHECK_EQUAL(*map.find(7), 10);
+}
+
+BOOST_AUTO_TEST_CASE(ThrowingUpdateLeavesKeyAbsent)
+{
+    threadsafe_hash_map<int, int> map;
+    auto fail = [](int &)
+    { throw std::runtime_error("update failed"); };
+    BOOST_CHECK_THROW(map.update(7, fail), std::runtime_error);
+    BOOST_CHECK(!map.contains(7));
+    BOOST_CHECK_EQUAL(map.size(), 0);
+    BOOST_CHECK(!map.erase(7));
+    BOOST_CHECK_EQUAL(map.size(), 0);
+
+    // an existing value keeps whatever func did before it threw
+    map.insert(7, 1);
+    BOOST_CHECK_THROW(map.update(7, [](int &v)
+                                 { v = 2; throw std::runtime_error("update failed"); }),
+                      std::runtime_error);
+    BOOST_CHECK_EQUAL(*map.find(7), 2);
+    BOOST_CHECK_EQUAL(map.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsStripes)
+{
+    threadsafe_hash_map<int, int> map(1);
+    for (int i = 0; i != 10000; ++i)
+        map.insert(i, -i);
+
+    BOOST_CHECK_EQUAL(map.size(), 10000);
+    for (int i = 0; i != 10000; ++i)
+        BOOST_CHECK_EQUAL(*map.find(i), -i);
+}
+
+BOOST_AUTO_TEST_CASE(MultiGet)
+{
+    threadsafe_hash_map<int, int> map;
+    for (int i = 0; i != 100; i += 2)
+        map.insert(i, i * 10);
+
+    std::vector<int> keys{4, 5, 98, 0, 99, 1000};
+    std::vector<std::optional<int>> values;
+    map.multi_get(keys.begin(), keys.end(), std::back_inserter(values));
+
+    BOOST_REQUIRE_EQUAL(values.size(), keys.size());
+    BOOST_CHECK_EQUAL(*values[0], 40);
+    BOOST_CHECK(!values[1]);
+    BOOST_CHECK_EQUAL(*values[2], 980);
+    BOOST_CHECK_EQUAL(*values[3], 0);
+    BOOST_CHECK(!values[4]);
+    BOOST_CHECK(!values[5]);
+}
+
+BOOST_AUTO_TEST_CASE(ReadersRunWhileTheirStripeGrows)
+{
+    threadsafe_hash_map<int, int, stalling_hash> map(1);
+    for (int i = -1; i != 7; ++i) // fills the 8 initial buckets of the only stripe
+        map.insert(i, i * 10);
+
+    // the ninth insert grows the stripe and stalls while rehashing key -1
+    std::thread writer([&map]
+                       {
+        stalling_hash::grower = std::this_thread::get_id();
+        map.insert(7, 70); });
+    while (!stalling_hash::stalled)
+        std::this_thread::yield();
+
+    // a reader of the growing stripe is not blocked, and sees the insert that triggered it
+    std::atomic<bool> done{false};
+    std::atomic<int> found{0};
+    std::thread reader([&]
+                       {
+        for (int i = -1; i != 8; ++i)
+            if (auto v = map.find(i); v && *v == i * 10)
+                ++found;
+        done = true; });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    bool read_during_growth = done;
+
+    stalling_hash::released = true;
+    writer.join();
+    reader.join();
+    BOOST_CHECK(read_during_growth);
+    BOOST_CHECK_EQUAL(found, 9);
+    BOOST_CHECK_EQUAL(map.size(), 9);
+    for (int i = -1; i != 8; ++i)
+        BOOST_CHECK_EQUAL(*map.find(i), i * 10);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentWritersAndReaders)
+{
+    threadsafe_hash_map<int, int> map(4);
+    const int per_thread = 5000;
+    std::atomic<int> mismatches{0}; // Boost.Test assertions are not thread safe
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t != 4; ++t)
+    {
+        threads.emplace_back([&map, t]()
+                             {
+            for (int i = 0; i != per_thread; ++i)
+                map.insert(t * per_thread + i, i); });
+        threads.emplace_back([&map, &mismatches]()
+                             {
+            for (int i = 0; i != per_thread; ++i)
+                if (auto v = map.find(i); v && *v != i)
+                    ++mismatches; });
+    }
+    for (auto &th : threads)
+        th.join();
+
+    BOOST_CHECK_EQUAL(mismatches, 0);
+    BOOST_CHECK_EQUAL(map.size(), 4 * per_thread);
+    for (int i = 0; i != 4 * per_thread; ++i)
+        BOOST_CHECK_EQUAL(*map.find(i), i % per_thread);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+/*
+hash map split into independently locked stripes
+
+every stripe is a small chained hash table guarded by its own shared_mutex, so readers of
+a stripe share the lock and operations on different stripes never contend. writers of a
+stripe are serialized by a second mutex and take the shared_mutex exclusively only for
+the moment they change a bucket.
+
+a stripe grows on its own without stopping its readers: the writer that pushed it over the
+load factor copies the entries into a new bucket array while holding only the writer mutex,
+so readers keep reading the old buckets, which no one else can change meanwhile, then takes
+the exclusive lock just to swap the arrays. the old array is freed after the lock is
+released. other writers of that stripe wait for the resize, all other stripes keep running.
+*/
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class threadsafe_hash_map
+{
+private:
+    using bucket = std::forward_list<std::pair<Key, Value>>;
+
+    // aligned so that the locks of neighbouring stripes never share a cache line
+    struct alignas(64) stripe
+    {
+        std::vector<bucket> buckets_;
+        size_t size_ = 0;
+        mutable std::shared_mutex m_; // shared by readers, exclusive while a bucket changes
+        std::mutex write_m_;          // held by the one writer of the stripe
+    };
+
+public:
+    // default constructor, stripes is rounded up to a power of two
+    explicit threadsafe_hash_map(size_t stripes = 64, const Hash &hash = Hash(),
+                                 const KeyEqual &eq = KeyEqual())
+        : stripes_(std::bit_ceil(std::max<size_t>(stripes, 1))), hash_(hash), eq_(eq)
+    {
+        for (stripe &s : stripes_)
+            s.buckets_.resize(initial_buckets);
+    }
+
+    // copy and assignment are deleted, a consistent copy would need every lock at once
+    threadsafe_hash_map(const threadsafe_hash_map &) = delete;
+    threadsafe_hash_map &operator=(const threadsafe_hash_map &) = delete;
+
+    // returns a copy of the value stored for key
+    std::optional<Value> find(const Key &key) const
+    {
+        size_t hash = hash_of(key);
+        const stripe &s = stripe_for(hash);
+        std::shared_lock<std::shared_mutex> lk(s.m_);
+
+        const bucket &b = bucket_for(s, hash);
+        for (const auto &kv : b)
+            if (eq_(kv.first, key))
+                return kv.second;
+        return std::nullopt;
+    }
+
+    bool contains(const Key &key) const { return find(key).has_value(); }
+
+    // inserts only if key is absent, returns whether it was inserted
+    bool insert(const Key &key, const Value &value)
+    {
+        size_t hash = hash_of(key);
+        stripe &s = stripe_for(hash);
+        std::lock_guard<std::mutex> wlk(s.write_m_);
+        {
+            std::unique_lock<std::shared_mutex> lk(s.m_);
+
+            bucket &b = bucket_for(s, hash);
+            for (const auto &kv : b)
+                if (eq_(kv.first, key))
+                    return false;
+
+            b.emplace_front(key, value);
+            ++s.size_;
+        }
+        grow_if_needed(s);
+        return true;
+    }
+
+    // returns true if a new element was inserted, false if an existing one was overwritten
+    bool insert_or_assign(const Key &key, const Value &value)
+    {
+        return update(key, [&value](Value &v)
+                      { v = value; });
+    }
+
+    /*
+    calls func on the value stored for key while the stripe is locked exclusively. if key
+    is absent func runs on a default constructed value, which is inserted once func returns,
+    so a throwing func leaves the map unchanged
+    */
+    template <typename Func>
+    bool update(const Key &key, Func &&func)
+    {
+        size_t hash = hash_of(key);
+        stripe &s = stripe_for(hash);
+        std::lock_guard<std::mutex> wlk(s.write_m_);
+        {
+            std::unique_lock<std::shared_mutex> lk(s.m_);
+
+            bucket &b = bucket_for(s, hash);
+            for (auto &kv : b)
+            {
+                if (eq_(kv.first, key))
+                {
+                    func(kv.second);
+                    return false;
+                }
+            }
+
+            Value value = Value();
+            func(value);
+            b.emplace_front(key, std::move(value));
+            ++s.size_;
+        }
+        grow_if_needed(s);
+        return true;
+    }
+
+    bool erase(const Key &key)
+    {
+        size_t hash = hash_of(key);
+        stripe &s = stripe_for(hash);
+        std::lock_guard<std::mutex> wlk(s.write_m_);
+        std::unique_lock<std::shared_mutex> lk(s.m_);
+
+        bucket &b = bucket_for(s, hash);
+        for (auto prev = b.before_begin(), it = b.begin(); it != b.end(); prev = it++)
+        {
+            if (eq_(it->first, key))
+            {
+                b.erase_after(prev);
+                --s.size_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    looks up every key in [first, last) and writes an std::optional<Value> per key to out,
+    keys are grouped by stripe so that each stripe is locked once for the whole batch
+    */
+    template <typename InIter, typename OutIter>
+    void multi_get(InIter first, InIter last, OutIter out) const
+    {
+        std::vector<const Key *> keys;
+        std::vector<size_t> hashes;
+        for (; first != last; ++first)
+        {
+            keys.push_back(&*first);
+            hashes.push_back(hash_of(*first));
+        }
+
+        std::vector<size_t> order(keys.size());
+        for (size_t i = 0; i != order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs)
+                  { return stripe_index(hashes[lhs]) < stripe_index(hashes[rhs]); });
+
+        std::vector<std::optional<Value>> results(keys.size());
+        for (size_t i = 0; i != order.size();)
+        {
+            const stripe &s = stripe_for(hashes[order[i]]);
+            std::shared_lock<std::shared_mutex> lk(s.m_);
+
+            for (; i != order.size() && &stripe_for(hashes[order[i]]) == &s; ++i)
+            {
+                size_t k = order[i];
+                for (const auto &kv : bucket_for(s, hashes[k]))
+                {
+                    if (eq_(kv.first, *keys[k]))
+                    {
+                        results[k] = kv.second;
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (auto &result : results)
+            *out++ = std::move(result);
+    }
+
+    // sum of the stripe sizes, only exact while no writer is running
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const stripe &s : stripes_)
+        {
+            std::shared_lock<std::shared_mutex> lk(s.m_);
+            total += s.size_;
+        }
+        return total;
+    }
+
+    bool empty() const { return 0 == size(); }
+
+    size_t stripe_count() const noexcept { return stripes_.size(); }
+
+private:
+    static constexpr size_t initial_buckets = 8;
+
+    // spreads weak hashes such as the identity std::hash<int> over all bits
+    size_t hash_of(const Key &key) const
+    {
+        uint64_t h = uint64_t(hash_(key)) * 0x9E3779B97F4A7C15ull;
+        return size_t(h ^ (h >> 29));
+    }
+
+    // the stripe takes the high half of the hash, the bucket inside it the low half
+    size_t stripe_index(size_t hash) const noexcept { return (hash >> 32) & (stripes_.size() - 1); }
+
+    stripe &stripe_for(size_t hash) { return stripes_[stripe_index(hash)]; }
+    const stripe &stripe_for(size_t hash) const { return stripes_[stripe_index(hash)]; }
+
+    static bucket &bucket_for(stripe &s, size_t hash)
+    {
+        return s.buckets_[hash & (s.buckets_.size() - 1)];
+    }
+
+    static const bucket &bucket_for(const stripe &s, size_t hash)
+    {
+        return s.buckets_[hash & (s.buckets_.size() - 1)];
+    }
+
+    /*
+    doubles the buckets of a stripe, the caller holds its writer mutex but not m_. the old
+    buckets are only read here and no other writer can change them, so readers share them
+    until the swap; the entries are copied because a reader may be walking any node
+    */
+    void grow_if_needed(stripe &s)
+    {
+        if (s.size_ <= s.buckets_.size())
+            return;
+
+        std::vector<bucket> buckets(s.buckets_.size() * 2);
+        for (const bucket &b : s.buckets_)
+            for (const auto &kv : b)
+                buckets[hash_of(kv.first) & (buckets.size() - 1)].push_front(kv);
+
+        {
+            std::unique_lock<std::shared_mutex> lk(s.m_);
+            s.buckets_.swap(buckets);
+        }
+        // the old buckets are freed here, outside the lock
+    }
+
+    std::vector<stripe> stripes_;
+    Hash hash_;
+    KeyEqual eq_;
+};
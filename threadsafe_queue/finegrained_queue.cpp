@@ -1,3 +1,6 @@
+#include "./../memory_accounting/memory_accounting.cpp"
+
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 
@@ -26,8 +29,31 @@ private:
         return std::move(lk);
     }
 
+    // accounting counts a node and its element, shared_ptr control blocks are not included
+    void pop_head()
+    {
+        head_ = std::move(head_->next_);
+        tag_.on_deallocate(sizeof(node) + sizeof(T));
+    }
+
 public:
-    threadsafe_queue() : head_(new node), tail_(head_.get()) {}
+    explicit threadsafe_queue(memory_tag tag = memory_tag())
+        : head_(new node), tail_(head_.get()), tag_(tag)
+    {
+        tag_.on_allocate(sizeof(node));
+    }
+
+    ~threadsafe_queue()
+    {
+        if constexpr (memory_tag::enabled)
+        {
+            size_t bytes = 0;
+            for (node *p = head_.get(); p; p = p->next_.get())
+                bytes += sizeof(node) + (p->data_ ? sizeof(T) : 0);
+            tag_.on_deallocate(bytes);
+        }
+    }
+
     threadsafe_queue(const threadsafe_queue &) = delete;
     threadsafe_queue &operator=(const threadsafe_queue &) = delete;
 
@@ -35,6 +61,7 @@ public:
     {
         std::shared_ptr<T> data = std::make_shared<T>(std::move(value));
         std::unique_ptr<node> new_dummy_node = std::make_unique<node>();
+        tag_.on_allocate(sizeof(node) + sizeof(T));
 
         {
             std::lock_guard<std::mutex> lk(tail_mutex_);
@@ -52,7 +79,7 @@ public:
     {
         std::unique_lock<std::mutex> lk(wait_for_data());
         std::shared_ptr<T> value(std::move(head_->data_));
-        head_ = std ::move(head_->next_);
+        pop_head();
         return value;
     }
 
@@ -60,7 +87,7 @@ public:
     {
         std::unique_lock<std::mutex> lk(wait_for_data());
         value = std::move(*(head_->data_));
-        head_ = std::move(head_->next_);
+        pop_head();
     }
 
     std::shared_ptr<T> try_pop()
@@ -70,7 +97,7 @@ public:
             return {};
 
         std::shared_ptr<T> value(std::move(head_->data_));
-        head_ = std::move(head_->next_);
+        pop_head();
         return value;
     }
 
@@ -80,7 +107,7 @@ public:
         if (head_.get() == get_tail())
             return false;
         value = std::move(*(head_->data_));
-        head_ = std::move(head_->next_);
+        pop_head();
         return true;
     }
 
@@ -92,4 +119,6 @@ private:
     std::mutex tail_mutex_;
 
     std::condition_variable cv_;
+
+    [[no_unique_address]] memory_tag tag_;
 };
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include "./../memory_accounting/memory_accounting.cpp"
+
 #include <mutex>
 #include <queue>
 #include <exception>
@@ -16,8 +18,9 @@ template <typename T>
 class threadsafe_queue
 {
 public:
-    // deafult constructor
-    threadsafe_queue() {}
+    // default constructor, the queue storage is accounted under tag
+    explicit threadsafe_queue(memory_tag tag = memory_tag())
+        : data_(std::deque<T, tagged_allocator<T>>(tagged_allocator<T>(tag))) {}
 
     // copy constructor
     threadsafe_queue(const threadsafe_queue &oth)
@@ -82,7 +85,7 @@ public:
     }
 
 private:
-    std::queue<T> data_;
+    std::queue<T, std::deque<T, tagged_allocator<T>>> data_;
     mutable std::mutex m_;
     std::condition_variable cv_;
 };
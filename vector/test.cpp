@@ -100,7 +100,8 @@ BOOST_AUTO_TEST_CASE(Constructor_SizeWithSpecificInitValue) {
   vector<int> v(initial_size, init_val);     // Calls vector(size_t, const T&)
   BOOST_CHECK_EQUAL(v.size(), initial_size); // Size should be initial_size
   BOOST_CHECK(v.capacity() >= initial_size); // Capacity should be at least size
-  // Elements should be initialized with init_val but cannot check directly
+  for (size_t i = 0; i != initial_size; ++i)
+    BOOST_CHECK_EQUAL(v[i], init_val);
 }
 
 BOOST_AUTO_TEST_CASE(Constructor_SizeZeroWithSpecificInitValue) {
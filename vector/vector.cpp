@@ -1,3 +1,5 @@
+#pragma once
+
 #include "vector_base.cpp"
 
 template <typename T, typename Alloc = std::allocator<T>> class vector {
@@ -6,14 +8,21 @@ template <typename T, typename Alloc = std::allocator<T>> class vector {
 public:
   vector() : vector_base_() {}
 
-  vector(size_t capacity, const T &init_val = T(), const Alloc &alloca = Alloc())
-      : vector_base_(capacity, alloca) {
-    vector_base_.uninitialized_fill(vector_base_.start_, vector_base_.end_, init_val);
+  explicit vector(memory_tag tag) : vector_base_(tag) {}
+
+  /* empty vector allocating through alloca, for allocators without a default state */
+  explicit vector(const Alloc &alloca, memory_tag tag = memory_tag()) : vector_base_(alloca, tag) {}
+
+  vector(size_t capacity, const T &init_val = T(), const Alloc &alloca = Alloc(),
+         memory_tag tag = memory_tag())
+      : vector_base_(capacity, alloca, tag) {
+    vector_base_.uninitialized_fill(vector_base_.start_, vector_base_.capacity_, init_val);
     vector_base_.end_ = vector_base_.capacity_;
   }
 
   // copy constructor
-  vector(const vector &oth) : vector_base_(oth.vector_base_.capacity(), oth.vector_base_.alloca_) {
+  vector(const vector &oth)
+      : vector_base_(oth.vector_base_.capacity(), oth.vector_base_.alloca_, oth.vector_base_.tag_) {
     vector_base_.uninitialized_copy(oth.vector_base_.start_, oth.vector_base_.end_,
                                     vector_base_.start_);
     vector_base_.end_ = vector_base_.start_ + oth.vector_base_.size();
@@ -39,7 +48,7 @@ public:
 
   ~vector() { destroy_range(vector_base_.start_, vector_base_.end_); }
 
-  friend void swap(vector<T> &lhs, vector<T> &rhs) noexcept {
+  friend void swap(vector &lhs, vector &rhs) noexcept {
     using std::swap;
     swap(lhs.vector_base_, rhs.vector_base_);
   }
@@ -49,7 +58,8 @@ public:
     if (new_capacity <= vector_base_.capacity())
       return;
 
-    Base new_base(new_capacity, vector_base_.alloca_);
+    Base new_base(new_capacity, vector_base_.alloca_, vector_base_.tag_);
+    new_base.tag_.on_reallocate();
     //    new_base.uninitialized_copy(vector_base_.start_, vector_base_.end_, new_base.start_);
     new_base.uninitialized_move(vector_base_.start_, vector_base_.end_, new_base.start_);
     new_base.end_ = new_base.start_ + vector_base_.size();
@@ -67,14 +77,15 @@ public:
       return;
     }
 
-    if (new_size < vector_base_.capacity()) {
+    if (new_size <= vector_base_.capacity()) {
       vector_base_.uninitialized_fill(vector_base_.end_, vector_base_.start_ + new_size,
                                       init_value);
       vector_base_.end_ = vector_base_.start_ + new_size;
       return;
     }
 
-    Base new_base(new_size, vector_base_.alloca_);
+    Base new_base(new_size, vector_base_.alloca_, vector_base_.tag_);
+    new_base.tag_.on_reallocate();
     //    new_base.uninitialized_copy(vector_base_.start_, vector_base_.end_, new_size.start_);
     new_base.uninitialized_move(vector_base_.start_, vector_base_.end_, new_base.start_);
     new_base.uninitialized_fill(new_base.start_ + vector_base_.size(), new_base.start_ + new_size,
@@ -113,8 +124,30 @@ public:
     swap(*this, tmp);
   }
 
+  void pop_back() {
+    --vector_base_.end_;
+    Base::AllocatorTraits::destroy(vector_base_.alloca_, vector_base_.end_);
+  }
+
+  T &operator[](size_t index) noexcept { return vector_base_.start_[index]; }
+  const T &operator[](size_t index) const noexcept { return vector_base_.start_[index]; }
+
+  T &front() noexcept { return *vector_base_.start_; }
+  const T &front() const noexcept { return *vector_base_.start_; }
+  T &back() noexcept { return *(vector_base_.end_ - 1); }
+  const T &back() const noexcept { return *(vector_base_.end_ - 1); }
+
+  T *data() noexcept { return vector_base_.start_; }
+  const T *data() const noexcept { return vector_base_.start_; }
+
+  T *begin() noexcept { return vector_base_.start_; }
+  T *end() noexcept { return vector_base_.end_; }
+  const T *begin() const noexcept { return vector_base_.start_; }
+  const T *end() const noexcept { return vector_base_.end_; }
+
   size_t size() const noexcept { return vector_base_.size(); }
   size_t capacity() const noexcept { return vector_base_.capacity(); }
+  bool empty() const noexcept { return 0 == vector_base_.size(); }
 
 private:
   void destroy_range(T *start, T *end) {
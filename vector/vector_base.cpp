@@ -1,18 +1,31 @@
+#pragma once
+
+#include "./../memory_accounting/memory_accounting.cpp"
+
 #include <memory>
 
 template <typename T, typename Alloc = std::allocator<T>> class vector_base {
 public:
   using AllocatorTraits = std::allocator_traits<Alloc>;
 
-  vector_base(size_t capacity, const Alloc &alloca = Alloc())
+  vector_base(size_t capacity, const Alloc &alloca = Alloc(), memory_tag tag = memory_tag())
       : alloca_(alloca), start_(AllocatorTraits::allocate(alloca_, capacity)), end_(start_),
-        capacity_(start_ + capacity) {}
+        capacity_(start_ + capacity), tag_(tag) {
+    tag_.on_allocate(capacity * sizeof(T));
+  }
 
   vector_base() : start_(nullptr), end_(nullptr), capacity_(nullptr) {}
 
+  explicit vector_base(memory_tag tag) : start_(nullptr), end_(nullptr), capacity_(nullptr), tag_(tag) {}
+
+  explicit vector_base(const Alloc &alloca, memory_tag tag = memory_tag())
+      : alloca_(alloca), start_(nullptr), end_(nullptr), capacity_(nullptr), tag_(tag) {}
+
   ~vector_base() {
-    if (start_)
+    if (start_) {
+      tag_.on_deallocate(capacity() * sizeof(T));
       AllocatorTraits::deallocate(alloca_, start_, capacity_ - start_);
+    }
   }
 
   // delete copy operations
@@ -22,7 +35,7 @@ public:
   // mov constructor
   vector_base(vector_base &&oth) noexcept
       : alloca_(std::move(oth.alloca_)), start_(oth.start_), end_(oth.end_),
-        capacity_(oth.capacity_) {
+        capacity_(oth.capacity_), tag_(oth.tag_) {
     oth.start_ = oth.end_ = oth.capacity_ = nullptr;
   }
 
@@ -34,7 +47,7 @@ public:
     return *this;
   }
 
-  friend void swap(vector_base<T> &lhs, vector_base<T> &rhs) noexcept {
+  friend void swap(vector_base &lhs, vector_base &rhs) noexcept {
     /*
     1. allows ADL to find a specialized lookup
       - using std::swap
@@ -48,6 +61,7 @@ public:
     swap(lhs.start_, rhs.start_);
     swap(lhs.end_, rhs.end_);
     swap(lhs.capacity_, rhs.capacity_);
+    swap(lhs.tag_, rhs.tag_);
   }
 
   size_t size() const noexcept { return end_ - start_; }
@@ -99,4 +113,6 @@ public:
   T *start_;     // points to the beginning of the memory region
   T *end_;       // points to the position where next element will be pushed
   T *capacity_;  // points to last valid position + 1
+
+  [[no_unique_address]] memory_tag tag_; // accounts the storage, travels with it on swap
 };